@@ -15,246 +15,3389 @@
  */
 
 #include "tdd_code.h"
+#include "white_box_code.h"
+
+#include <cmath>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <deque>
+#include <memory>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <limits>
+#include <bitset>
+
+// Distribuované barvení spouští pracovní procesy přes fork a soketové páry
+#if defined(__unix__) || defined(__APPLE__)
+#define GRAPH_WORKER_PROCESSES 1
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Počet nulových bitů na konci nenulového slova.
+ * @param[in] word slovo, nesmí být nulové
+ * @return index nejnižšího nastaveného bitu
+ */
+inline unsigned countTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return unsigned(index);
+#else
+    unsigned count = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Počet nastavených bitů slova.
+ * @param[in] word slovo
+ * @return počet jedničkových bitů
+ */
+inline unsigned popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(__builtin_popcountll(word));
+#else
+    return unsigned(std::bitset<64>(word).count());
+#endif
+}
+
+/**
+ * @brief Bitová maska barev obsazených sousedy právě barveného uzlu.
+ *
+ * Barva c odpovídá bitu c - 1. Maska je znovupoužitelná mezi uzly, takže
+ * výběr barvy nevyžaduje žádnou alokaci a trvá O(stupeň uzlu). První volnou
+ * barvu najde instrukce count-trailing-zeros nad negovaným slovem.
+ */
+class ColorMask {
+public:
+    /**
+     * @brief Připraví vynulovanou masku pro barvy 1 až @p maxColor.
+     * @param[in] maxColor nejvyšší sledovaná barva
+     */
+    void prepare(size_t maxColor) {
+        m_maxColor = maxColor;
+        size_t words = maxColor / 64 + 1;
+        if (m_words.size() < words) {
+            m_words.resize(words, 0);
+        }
+        std::fill(m_words.begin(), m_words.begin() + words, 0);
+    }
+
+    /**
+     * @brief Označí barvu jako obsazenou, barvy 0 a vyšší než maximum ignoruje.
+     * @param[in] color barva souseda
+     */
+    void mark(size_t color) {
+        if (color != 0 && color <= m_maxColor) {
+            m_words[(color - 1) >> 6] |= uint64_t(1) << ((color - 1) & 63);
+        }
+    }
+
+    /**
+     * @return nejmenší neobsazená barva
+     */
+    size_t firstFree() const {
+        for (size_t word = 0;; ++word) {
+            uint64_t freeBits = ~m_words[word];
+            if (freeBits != 0) {
+                return word * 64 + countTrailingZeros(freeBits) + 1;
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+    size_t m_maxColor = 0;
+};
+
+// Nejmenší počet uzlů, od kterého se vyplatí udržovat bitovou matici sousednosti
+constexpr size_t DENSE_MATRIX_MIN_NODES = 64;
+
+/**
+ * @brief Zjistí, zda mají dvě bitové množiny společný prvek.
+ * @param[in] a první množina
+ * @param[in] b druhá množina
+ * @param[in] words počet 64bitových slov množin
+ * @return true pokud je průnik neprázdný
+ */
+bool bitsIntersect(const uint64_t* a, const uint64_t* b, size_t words) {
+    for (size_t i = 0; i < words; ++i) {
+        if (a[i] & b[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Spočítá velikost průniku dvou bitových množin.
+ * @param[in] a první množina
+ * @param[in] b druhá množina
+ * @param[in] words počet 64bitových slov množin
+ * @return počet společných prvků
+ */
+size_t bitsIntersectionCount(const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t count = 0;
+    for (size_t i = 0; i < words; ++i) {
+        count += popcount(a[i] & b[i]);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Zjistí, zda obarvení v husté reprezentaci nemá konflikt ani neobarvený uzel.
+ * @param[in] offsets začátky seznamů sousedů
+ * @param[in] targets husté indexy sousedů
+ * @param[in] colors barvy uzlů
+ * @return true pokud je obarvení platné
+ */
+bool isValidColoring(const std::vector<size_t>& offsets, const std::vector<size_t>& targets,
+                     const std::vector<size_t>& colors) {
+    for (size_t v = 0; v < colors.size(); ++v) {
+        if (colors[v] == 0) {
+            return false;
+        }
+        for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+            if (colors[targets[i]] == colors[v]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Počet kroků mezi dvěma čteními hodin při hlídání časového limitu
+constexpr size_t DEADLINE_CHECK_INTERVAL = 256;
+
+/**
+ * @brief Časový limit hlídaný uvnitř dlouhých kroků zlepšování obarvení.
+ *
+ * Hodiny se čtou jen při každém DEADLINE_CHECK_INTERVAL-tém dotazu, aby
+ * kontrola v nejvnitřnějších smyčkách nic nestála.
+ */
+class StepDeadline {
+public:
+    /**
+     * @param[in] enabled zda se má limit hlídat
+     * @param[in] deadline okamžik vypršení limitu
+     */
+    StepDeadline(bool enabled, std::chrono::steady_clock::time_point deadline)
+        : m_enabled(enabled), m_deadline(deadline) {}
+
+    /**
+     * @return true pokud limit vypršel
+     */
+    bool expired() {
+        if (!m_enabled || m_expired) {
+            return m_expired;
+        }
+        if (++m_calls % DEADLINE_CHECK_INTERVAL == 0) {
+            m_expired = std::chrono::steady_clock::now() >= m_deadline;
+        }
+        return m_expired;
+    }
+
+private:
+    bool m_enabled;
+    bool m_expired = false;
+    size_t m_calls = 0;
+    std::chrono::steady_clock::time_point m_deadline;
+};
+
+/**
+ * @brief Jeden krok iterovaného hladového barvení (Culberson).
+ *
+ * Uzly se obarví první volnou barvou po celých třídách dosavadního obarvení
+ * v pořadí tříd určeném strategií. Protože každá třída je nezávislá množina,
+ * nový počet barev nepřekročí původní.
+ *
+ * @param[in] offsets začátky seznamů sousedů
+ * @param[in] targets husté indexy sousedů
+ * @param[in, out] colors barvy uzlů
+ * @param[in] strategy pořadí tříd: 0 obrácené, 1 od největší, 2 od nejmenší, jinak náhodné
+ * @param[in, out] engine generátor náhodných čísel
+ * @param[in, out] mask pracovní maska barev
+ * @param[in, out] deadline časový limit, po jeho vypršení se krok přeruší
+ * @return false pokud byl krok přerušen, obarvení je pak neúplné
+ */
+bool iteratedGreedyStep(const std::vector<size_t>& offsets, const std::vector<size_t>& targets,
+                        std::vector<size_t>& colors, size_t strategy, std::mt19937_64& engine,
+                        ColorMask& mask, StepDeadline& deadline) {
+    size_t colorCount = *std::max_element(colors.begin(), colors.end());
+    std::vector<std::vector<size_t>> classes(colorCount);
+    for (size_t v = 0; v < colors.size(); ++v) {
+        classes[colors[v] - 1].push_back(v);
+    }
+
+    switch (strategy) {
+        case 0:
+            std::reverse(classes.begin(), classes.end());
+            break;
+        case 1:
+            std::stable_sort(classes.begin(), classes.end(), [](const auto& a, const auto& b) {
+                return a.size() > b.size();
+            });
+            break;
+        case 2:
+            std::stable_sort(classes.begin(), classes.end(), [](const auto& a, const auto& b) {
+                return a.size() < b.size();
+            });
+            break;
+        default:
+            std::shuffle(classes.begin(), classes.end(), engine);
+            break;
+    }
+
+    std::fill(colors.begin(), colors.end(), 0);
+    for (const auto& colorClass : classes) {
+        for (size_t v : colorClass) {
+            if (deadline.expired()) {
+                return false;
+            }
+            mask.prepare(offsets[v + 1] - offsets[v] + 1);
+            for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                mask.mark(colors[targets[i]]);
+            }
+            colors[v] = mask.firstFree();
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Pomocná data pro prohledávání Kempeho řetězců.
+ */
+struct KempeScratch {
+    std::vector<size_t> stamp;      ///< značka poslední návštěvy uzlu
+    std::vector<size_t> component;  ///< uzly nalezeného řetězce
+    size_t current = 0;             ///< aktuální značka
+};
+
+/**
+ * @brief Pokusí se přebarvit uzel na barvu nižší než @p limit.
+ *
+ * Nejprve zkusí volnou barvu, poté pro dvojice barev (c, d) prohodí barvy
+ * v Kempeho řetězci obsahujícím sousedy barvy c, pokud řetězec neobsahuje
+ * žádného souseda barvy d. Výměna barev v řetězci zachovává platnost.
+ *
+ * @param[in] offsets začátky seznamů sousedů
+ * @param[in] targets husté indexy sousedů
+ * @param[in, out] colors barvy uzlů
+ * @param[in] v přebarvovaný uzel
+ * @param[in] limit horní mez (výlučně) pro novou barvu
+ * @param[in, out] mask pracovní maska barev
+ * @param[in, out] scratch pracovní data prohledávání
+ * @param[in, out] deadline časový limit, po jeho vypršení se hledání vzdá
+ * @return true pokud byl uzel přebarven
+ */
+bool kempeRecolor(const std::vector<size_t>& offsets, const std::vector<size_t>& targets,
+                  std::vector<size_t>& colors, size_t v, size_t limit, ColorMask& mask,
+                  KempeScratch& scratch, StepDeadline& deadline) {
+    mask.prepare(offsets[v + 1] - offsets[v] + 1);
+    for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        mask.mark(colors[targets[i]]);
+    }
+    size_t freeColor = mask.firstFree();
+    if (freeColor < limit) {
+        colors[v] = freeColor;
+        return true;
+    }
+
+    for (size_t c = 1; c < limit; ++c) {
+        for (size_t d = 1; d < limit; ++d) {
+            if (c == d) {
+                continue;
+            }
+            if (deadline.expired()) {
+                return false;
+            }
+
+            // Řetězec barev c a d vycházející ze sousedů uzlu v barvy c
+            ++scratch.current;
+            scratch.component.clear();
+            for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                size_t w = targets[i];
+                if (colors[w] == c && scratch.stamp[w] != scratch.current) {
+                    scratch.stamp[w] = scratch.current;
+                    scratch.component.push_back(w);
+                }
+            }
+
+            for (size_t head = 0; head < scratch.component.size(); ++head) {
+                size_t u = scratch.component[head];
+                for (size_t i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    size_t w = targets[i];
+                    if ((colors[w] == c || colors[w] == d) && scratch.stamp[w] != scratch.current) {
+                        scratch.stamp[w] = scratch.current;
+                        scratch.component.push_back(w);
+                    }
+                }
+            }
+
+            // Sousedé barvy d nesmí být v řetězci, jinak by po výměně měli barvu c
+            bool blocked = false;
+            for (size_t i = offsets[v]; i < offsets[v + 1] && !blocked; ++i) {
+                size_t w = targets[i];
+                blocked = colors[w] == d && scratch.stamp[w] == scratch.current;
+            }
+            if (blocked) {
+                continue;
+            }
+
+            for (size_t u : scratch.component) {
+                colors[u] = colors[u] == c ? d : c;
+            }
+            colors[v] = c;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Najde nejmenší barvu nezakázanou v okolí vzdálenosti 2 uzlu @p v.
+ *
+ * Pole @p forbidden obsahuje pro každou barvu razítko posledního uzlu, který
+ * ji zakázal, takže jej není nutné mezi uzly mazat.
+ *
+ * @param[in] offsets začátky seznamů sousedů
+ * @param[in] targets husté indexy sousedů
+ * @param[in] member příznak, zda je uzel barven
+ * @param[in] colors barvy uzlů
+ * @param[in] v barvený uzel
+ * @param[in, out] forbidden razítka zakázaných barev
+ * @return nejmenší povolená barva
+ */
+template<typename ColorVector>
+size_t firstDistance2Color(const std::vector<size_t>& offsets, const std::vector<size_t>& targets,
+                           const std::vector<char>& member, const ColorVector& colors, size_t v,
+                           std::vector<size_t>& forbidden) {
+    size_t stamp = v + 1;
+    auto forbid = [&](size_t color) {
+        if (color != 0) {
+            if (forbidden.size() <= color) {
+                forbidden.resize(2 * color + 1, 0);
+            }
+            forbidden[color] = stamp;
+        }
+    };
+
+    for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        size_t w = targets[i];
+        if (member[w]) {
+            forbid(colors[w]);
+        }
+        for (size_t j = offsets[w]; j < offsets[w + 1]; ++j) {
+            size_t x = targets[j];
+            if (x != v && member[x]) {
+                forbid(colors[x]);
+            }
+        }
+    }
+
+    size_t color = 1;
+    while (color < forbidden.size() && forbidden[color] == stamp) {
+        ++color;
+    }
+
+    return color;
+}
+
+/**
+ * @brief Obarví vybrané uzly tak, aby uzly ve vzdálenosti nejvýše 2 měly různé barvy.
+ *
+ * Jedno vlákno barví uzly sestupně podle stupně. Při více vláknech se
+ * opakuje spekulativní souběžné barvení a detekce konfliktů, dokud nějaké
+ * konflikty zbývají; z konfliktní dvojice se přebarvuje uzel s vyšším
+ * indexem, takže počet konfliktů postupně klesá k nule.
+ *
+ * @param[in] offsets začátky seznamů sousedů
+ * @param[in] targets husté indexy sousedů
+ * @param[in] member příznak, zda je uzel barven
+ * @param[in] threadCount počet vláken
+ * @return barvy uzlů, nevybrané uzly mají barvu 0
+ */
+std::vector<size_t> distance2Colors(const std::vector<size_t>& offsets, const std::vector<size_t>& targets,
+                                    const std::vector<char>& member, size_t threadCount) {
+    size_t nodeCount = member.size();
+    std::vector<size_t> pending;
+    for (size_t v = 0; v < nodeCount; ++v) {
+        if (member[v]) {
+            pending.push_back(v);
+        }
+    }
+    std::stable_sort(pending.begin(), pending.end(), [&](size_t a, size_t b) {
+        return offsets[a + 1] - offsets[a] > offsets[b + 1] - offsets[b];
+    });
+
+    if (threadCount <= 1) {
+        std::vector<size_t> colors(nodeCount, 0);
+        std::vector<size_t> forbidden;
+        for (size_t v : pending) {
+            colors[v] = firstDistance2Color(offsets, targets, member, colors, v, forbidden);
+        }
+        return colors;
+    }
+
+    // Barvy čtou i zapisují všechna vlákna, proto jsou atomické
+    std::vector<std::atomic<size_t>> colors(nodeCount);
+    for (auto& color : colors) {
+        color.store(0, std::memory_order_relaxed);
+    }
+
+    auto parallelFor = [threadCount](size_t count, const std::function<void(size_t, size_t, size_t)>& body) {
+        std::vector<std::thread> threads;
+        size_t chunk = (count + threadCount - 1) / threadCount;
+        for (size_t t = 0; t < threadCount; ++t) {
+            size_t begin = std::min(count, t * chunk);
+            size_t end = std::min(count, begin + chunk);
+            threads.emplace_back(body, t, begin, end);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+
+    std::vector<std::vector<size_t>> forbidden(threadCount);
+    while (!pending.empty()) {
+        parallelFor(pending.size(), [&](size_t thread, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                size_t v = pending[i];
+                colors[v].store(firstDistance2Color(offsets, targets, member, colors, v, forbidden[thread]),
+                                std::memory_order_relaxed);
+            }
+        });
+
+        std::vector<std::vector<size_t>> conflicts(threadCount);
+        parallelFor(pending.size(), [&](size_t thread, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                size_t v = pending[i];
+                size_t color = colors[v].load(std::memory_order_relaxed);
+                bool conflict = false;
+                for (size_t j = offsets[v]; j < offsets[v + 1] && !conflict; ++j) {
+                    size_t w = targets[j];
+                    conflict = member[w] && w < v && colors[w].load(std::memory_order_relaxed) == color;
+                    for (size_t k = offsets[w]; k < offsets[w + 1] && !conflict; ++k) {
+                        size_t x = targets[k];
+                        conflict = member[x] && x < v && colors[x].load(std::memory_order_relaxed) == color;
+                    }
+                }
+                if (conflict) {
+                    conflicts[thread].push_back(v);
+                }
+            }
+        });
+
+        pending.clear();
+        for (const auto& threadConflicts : conflicts) {
+            pending.insert(pending.end(), threadConflicts.begin(), threadConflicts.end());
+        }
+    }
+
+    std::vector<size_t> result(nodeCount);
+    for (size_t v = 0; v < nodeCount; ++v) {
+        result[v] = colors[v].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Tabulka barev hran pro algoritmus Misra-Gries.
+ *
+ * Pro každý uzel a barvu uchovává souseda, se kterým uzel spojuje hrana dané
+ * barvy. Test, zda je barva na uzlu volná, i nalezení hrany dané barvy tak
+ * trvají O(1).
+ */
+class EdgeColorTable {
+public:
+    static constexpr size_t NONE = static_cast<size_t>(-1);  ///< barva na uzlu je volná
+
+    /**
+     * @param[in] nodeCount počet uzlů
+     * @param[in] colorCount počet barev
+     */
+    EdgeColorTable(size_t nodeCount, size_t colorCount)
+        : m_colorCount(colorCount), m_table(nodeCount * colorCount, NONE) {}
+
+    /** @return soused spojený hranou barvy @p color nebo NONE */
+    size_t at(size_t v, size_t color) const {
+        return m_table[v * m_colorCount + color];
+    }
+
+    /** @return true pokud na uzlu @p v nekončí hrana barvy @p color */
+    bool isFree(size_t v, size_t color) const {
+        return at(v, color) == NONE;
+    }
+
+    /** @return nejmenší volná barva uzlu */
+    size_t freeColor(size_t v) const {
+        size_t color = 0;
+        while (!isFree(v, color)) {
+            ++color;
+        }
+        return color;
+    }
+
+    /** @brief Obarví hranu (u, v) barvou @p color. */
+    void set(size_t u, size_t v, size_t color) {
+        m_table[u * m_colorCount + color] = v;
+        m_table[v * m_colorCount + color] = u;
+    }
+
+    /** @brief Odebere hraně (u, v) barvu @p color. */
+    void unset(size_t u, size_t v, size_t color) {
+        m_table[u * m_colorCount + color] = NONE;
+        m_table[v * m_colorCount + color] = NONE;
+    }
+
+    /** @return barva hrany (u, v), hrana musí být obarvena, trvá O(Δ) */
+    size_t colorOf(size_t u, size_t v) const {
+        size_t color = 0;
+        while (at(u, color) != v) {
+            ++color;
+        }
+        return color;
+    }
+
+private:
+    size_t m_colorCount;
+    std::vector<size_t> m_table;
+};
+
+/**
+ * @brief Obarví hranu (x, f) algoritmem Misra-Gries.
+ *
+ * Sestaví maximální vějíř uzlu x začínající uzlem f, invertuje cd-cestu
+ * z uzlu x, kde c je volná na x a d na posledním uzlu vějíře, a posune barvy
+ * v nejkratším prefixu vějíře končícím uzlem w, na kterém je d volná.
+ *
+ * Sestavení vějíře prochází pro každé jeho rozšíření všechny barvy, takže
+ * jedna hrana stojí O(Δ²) na vějíř, O(Δ) na každé colorOf a O(|V|) na
+ * inverzi cesty.
+ *
+ * @param[in, out] table tabulka barev hran
+ * @param[in] colorCount počet barev (stupeň grafu + 1)
+ * @param[in] x první uzel hrany
+ * @param[in] f druhý uzel hrany
+ * @param[in, out] inFan pracovní příznaky uzlů vějíře
+ */
+void misraGriesColorEdge(EdgeColorTable& table, size_t colorCount, size_t x, size_t f, std::vector<char>& inFan) {
+    // Maximální vějíř: barva hrany (x, fan[i + 1]) je volná na fan[i]
+    std::vector<size_t> fan{f};
+    inFan[f] = 1;
+    bool extended = true;
+    while (extended) {
+        extended = false;
+        for (size_t color = 0; color < colorCount && !extended; ++color) {
+            size_t u = table.at(x, color);
+            if (table.isFree(fan.back(), color) && u != EdgeColorTable::NONE && !inFan[u]) {
+                fan.push_back(u);
+                inFan[u] = 1;
+                extended = true;
+            }
+        }
+    }
+    for (size_t u : fan) {
+        inFan[u] = 0;
+    }
+
+    size_t c = table.freeColor(x);
+    size_t d = table.freeColor(fan.back());
+
+    // Inverze cd-cesty začínající v x hranou barvy d
+    if (c != d) {
+        struct PathEdge { size_t u; size_t v; size_t color; };
+        std::vector<PathEdge> path;
+        size_t current = x;
+        size_t color = d;
+        while (table.at(current, color) != EdgeColorTable::NONE) {
+            size_t next = table.at(current, color);
+            path.push_back({current, next, color});
+            current = next;
+            color = color == d ? c : d;
+        }
+        for (const PathEdge& edge : path) {
+            table.unset(edge.u, edge.v, edge.color);
+        }
+        for (const PathEdge& edge : path) {
+            table.set(edge.u, edge.v, edge.color == d ? c : d);
+        }
+    }
+
+    // Nejkratší prefix vějíře, který zůstal vějířem a končí uzlem s volnou barvou d
+    size_t w = 0;
+    while (!table.isFree(fan[w], d)) {
+        if (w + 1 >= fan.size() || !table.isFree(fan[w], table.colorOf(x, fan[w + 1]))) {
+            throw std::logic_error("Misra-Gries fan invariant violated");
+        }
+        ++w;
+    }
+
+    // Rotace vějíře
+    std::vector<size_t> shifted(w);
+    for (size_t i = 0; i < w; ++i) {
+        shifted[i] = table.colorOf(x, fan[i + 1]);
+    }
+    for (size_t i = 0; i < w; ++i) {
+        table.unset(x, fan[i + 1], shifted[i]);
+    }
+    for (size_t i = 0; i < w; ++i) {
+        table.set(x, fan[i], shifted[i]);
+    }
+    table.set(x, fan[w], d);
+}
+
+/**
+ * @brief Rozparsuje jeden řádek seznamu hran.
+ *
+ * Řádek obsahuje dvojici id uzlů oddělených mezerami nebo tabulátory.
+ * Prázdné řádky, komentáře začínající znakem # a řádky bez dvojice čísel
+ * nejsou hranou.
+ *
+ * @param[in] begin začátek řádku
+ * @param[in] end konec řádku bez znaku nového řádku
+ * @param[out] a id prvního uzlu
+ * @param[out] b id druhého uzlu
+ * @return true pokud řádek obsahuje hranu
+ * @exception out_of_range pokud se id uzlu nevejde do size_t
+ */
+bool parseEdgeLine(const char* begin, const char* end, size_t& a, size_t& b) {
+    size_t* ids[2] = {&a, &b};
+    for (size_t* id : ids) {
+        while (begin != end && (*begin == ' ' || *begin == '\t')) {
+            ++begin;
+        }
+        if (begin == end || *begin < '0' || *begin > '9') {
+            return false;
+        }
+
+        *id = 0;
+        while (begin != end && *begin >= '0' && *begin <= '9') {
+            size_t digit = static_cast<size_t>(*begin - '0');
+            if (*id > (std::numeric_limits<size_t>::max() - digit) / 10) {
+                throw std::out_of_range("Node id out of range");
+            }
+            *id = *id * 10 + digit;
+            ++begin;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Přečte ze souboru se seznamem hran další hranu.
+ *
+ * Přeskakuje řádky, které podle parseEdgeLine neobsahují hranu.
+ *
+ * @param[in, out] input vstupní proud
+ * @param[in, out] line pracovní buffer řádku
+ * @param[out] a id prvního uzlu
+ * @param[out] b id druhého uzlu
+ * @return false na konci souboru
+ * @exception out_of_range pokud se id uzlu nevejde do size_t
+ */
+bool readEdgeLine(std::istream& input, std::string& line, size_t& a, size_t& b) {
+    while (std::getline(input, line)) {
+        if (parseEdgeLine(line.data(), line.data() + line.size(), a, b)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Jedinečný dočasný adresář pro soubory segmentů.
+ *
+ * Adresář se vytvoří v konstruktoru a destruktor jej smaže i s obsahem,
+ * takže souběžné běhy se nepřepisují a výjimka nenechá soubory na disku.
+ */
+class ShardDirectory {
+public:
+    /**
+     * @param[in] parent adresář, ve kterém se dočasný adresář vytvoří
+     * @exception runtime_error pokud adresář nelze vytvořit
+     */
+    explicit ShardDirectory(const std::string& parent) {
+        std::random_device device;
+        std::mt19937_64 engine((uint64_t(device()) << 32) ^ device());
+        for (size_t attempt = 0; attempt < 100; ++attempt) {
+            std::filesystem::path candidate = std::filesystem::path(parent) / ("graph_shards_" + std::to_string(engine()));
+            std::error_code error;
+            // create_directory vrací false, pokud adresář již existuje
+            if (std::filesystem::create_directory(candidate, error)) {
+                m_path = candidate;
+                return;
+            }
+            if (error) {
+                break;
+            }
+        }
+        throw std::runtime_error("Cannot create shard directory in " + parent);
+    }
+
+    ShardDirectory(const ShardDirectory&) = delete;
+    ShardDirectory& operator=(const ShardDirectory&) = delete;
+
+    ~ShardDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(m_path, error);
+    }
+
+    /** @return cesta k adresáři */
+    const std::filesystem::path& path() const {
+        return m_path;
+    }
+
+private:
+    std::filesystem::path m_path;
+};
+
+/**
+ * @brief Otevře soubor se seznamem hran.
+ * @param[in] path cesta k souboru
+ * @return otevřený vstupní proud
+ * @exception runtime_error pokud soubor nelze otevřít
+ */
+std::ifstream openEdgeFile(const std::string& path) {
+    std::ifstream input(path);
+    if (!input) {
+        throw std::runtime_error("Cannot open edge file " + path);
+    }
+
+    return input;
+}
+
+#ifdef GRAPH_WORKER_PROCESSES
+
+/**
+ * @brief Zapíše do soketu zprávu s délkou a 64bitovými slovy.
+ * @param[in] fd soket
+ * @param[in] words obsah zprávy
+ * @return počet zapsaných bajtů
+ * @exception runtime_error pokud zápis selže
+ */
+size_t sendMessage(int fd, const std::vector<uint64_t>& words) {
+    uint64_t length = words.size();
+    const char* parts[2] = {reinterpret_cast<const char*>(&length), reinterpret_cast<const char*>(words.data())};
+    size_t sizes[2] = {sizeof(length), words.size() * sizeof(uint64_t)};
+
+    for (size_t part = 0; part < 2; ++part) {
+        size_t written = 0;
+        while (written < sizes[part]) {
+#ifdef MSG_NOSIGNAL
+            // Zápis do soketu ukončeného procesu nesmí ukončit koordinátor signálem SIGPIPE
+            ssize_t result = ::send(fd, parts[part] + written, sizes[part] - written, MSG_NOSIGNAL);
+#else
+            ssize_t result = ::write(fd, parts[part] + written, sizes[part] - written);
+#endif
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                throw std::runtime_error("Cannot write to worker socket");
+            }
+            written += static_cast<size_t>(result);
+        }
+    }
+
+    return sizes[0] + sizes[1];
+}
+
+/**
+ * @brief Přečte ze soketu zprávu zapsanou funkcí sendMessage.
+ * @param[in] fd soket
+ * @param[out] words obsah zprávy
+ * @return počet přečtených bajtů
+ * @exception runtime_error pokud čtení selže nebo protistrana soket zavře
+ */
+size_t receiveMessage(int fd, std::vector<uint64_t>& words) {
+    uint64_t length = 0;
+    auto readAll = [fd](char* buffer, size_t size) {
+        size_t received = 0;
+        while (received < size) {
+            ssize_t result = ::read(fd, buffer + received, size - received);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                throw std::runtime_error("Cannot read from worker socket");
+            }
+            received += static_cast<size_t>(result);
+        }
+    };
+
+    readAll(reinterpret_cast<char*>(&length), sizeof(length));
+    words.resize(length);
+    readAll(reinterpret_cast<char*>(words.data()), length * sizeof(uint64_t));
+
+    return sizeof(length) + length * sizeof(uint64_t);
+}
+
+/**
+ * @brief Hlavní smyčka pracovního procesu distribuovaného barvení.
+ *
+ * První zpráva obsahuje uzly oddílu ve tvaru (index, stupeň, sousedé...).
+ * Každá další zpráva začíná příznakem pokračování a obsahuje dvojice
+ * (index, barva): pro cizí uzly jde o jejich novou barvu, pro vlastní uzly
+ * barva 0 znamená pokyn k přebarvení. Proces odpoví dvojicemi pro své
+ * hraniční uzly obarvené v tomto kole, na závěrečnou zprávu odpoví barvami
+ * všech svých uzlů.
+ *
+ * @param[in] fd soket spojený s koordinátorem
+ */
+void distributedWorker(int fd) {
+    std::vector<uint64_t> message;
+    receiveMessage(fd, message);
+
+    std::vector<uint64_t> nodes;
+    std::vector<size_t> offsets{0};
+    std::vector<uint64_t> neighbors;
+    std::unordered_map<uint64_t, size_t> local;
+    for (size_t i = 0; i < message.size();) {
+        local[message[i]] = nodes.size();
+        nodes.push_back(message[i]);
+        size_t degree = message[i + 1];
+        neighbors.insert(neighbors.end(), message.begin() + i + 2, message.begin() + i + 2 + degree);
+        offsets.push_back(neighbors.size());
+        i += 2 + degree;
+    }
+
+    std::vector<uint64_t> colors(nodes.size(), 0);
+    std::vector<char> boundary(nodes.size(), 0);
+    std::unordered_map<uint64_t, uint64_t> ghostColors;
+    for (size_t v = 0; v < nodes.size(); ++v) {
+        for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+            if (local.find(neighbors[i]) == local.end()) {
+                boundary[v] = 1;
+                ghostColors[neighbors[i]] = 0;
+            }
+        }
+    }
+
+    ColorMask usedColors;
+    while (true) {
+        receiveMessage(fd, message);
+        for (size_t i = 1; i + 1 < message.size(); i += 2) {
+            auto it = local.find(message[i]);
+            if (it != local.end()) {
+                colors[it->second] = message[i + 1];
+            } else {
+                ghostColors[message[i]] = message[i + 1];
+            }
+        }
+
+        std::vector<uint64_t> reply;
+        if (message[0] == 0) {
+            for (size_t v = 0; v < nodes.size(); ++v) {
+                reply.push_back(nodes[v]);
+                reply.push_back(colors[v]);
+            }
+            sendMessage(fd, reply);
+            return;
+        }
+
+        for (size_t v = 0; v < nodes.size(); ++v) {
+            if (colors[v] != 0) {
+                continue;
+            }
+            usedColors.prepare(offsets[v + 1] - offsets[v] + 1);
+            for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                auto it = local.find(neighbors[i]);
+                usedColors.mark(it != local.end() ? colors[it->second] : ghostColors[neighbors[i]]);
+            }
+            colors[v] = usedColors.firstFree();
+            if (boundary[v]) {
+                reply.push_back(nodes[v]);
+                reply.push_back(colors[v]);
+            }
+        }
+        sendMessage(fd, reply);
+    }
+}
+
+/**
+ * @brief Pracovní procesy distribuovaného barvení a jejich sokety.
+ *
+ * Destruktor zavře všechny sokety a počká na všechny spuštěné procesy,
+ * takže ani výjimka uprostřed spouštění nebo komunikace nenechá procesy
+ * ani sokety viset. Proces po zavření soketu skončí chybou čtení.
+ */
+class WorkerProcesses {
+public:
+    WorkerProcesses() = default;
+    WorkerProcesses(const WorkerProcesses&) = delete;
+    WorkerProcesses& operator=(const WorkerProcesses&) = delete;
+
+    ~WorkerProcesses() {
+        finish();
+    }
+
+    /**
+     * @brief Spustí další pracovní proces spojený soketovým párem.
+     * @exception runtime_error pokud nelze vytvořit soket nebo proces
+     */
+    void start() {
+        // Po fork už se nesmí nic alokovat, jinak by proces nebyl evidován
+        m_sockets.reserve(m_sockets.size() + 1);
+        m_pids.reserve(m_pids.size() + 1);
+
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            throw std::runtime_error("Cannot create worker socket");
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(pair[0]);
+            close(pair[1]);
+            throw std::runtime_error("Cannot start worker process");
+        }
+        if (pid == 0) {
+            for (int fd : m_sockets) {
+                close(fd);
+            }
+            close(pair[0]);
+            int status = 0;
+            try {
+                distributedWorker(pair[1]);
+            } catch (...) {
+                status = 1;
+            }
+            _exit(status);
+        }
+
+        close(pair[1]);
+        m_sockets.push_back(pair[0]);
+        m_pids.push_back(pid);
+    }
+
+    /**
+     * @param[in] worker index procesu
+     * @return soket spojený s procesem
+     */
+    int socket(size_t worker) const {
+        return m_sockets[worker];
+    }
+
+    /**
+     * @brief Zavře sokety a počká na ukončení všech procesů.
+     * @return true pokud všechny procesy skončily úspěšně
+     */
+    bool finish() {
+        bool succeeded = true;
+        for (size_t worker = 0; worker < m_pids.size(); ++worker) {
+            close(m_sockets[worker]);
+            int status = 0;
+            pid_t result;
+            do {
+                result = waitpid(m_pids[worker], &status, 0);
+            } while (result < 0 && errno == EINTR);
+            succeeded = succeeded && result >= 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        m_sockets.clear();
+        m_pids.clear();
+
+        return succeeded;
+    }
+
+private:
+    std::vector<int> m_sockets;
+    std::vector<pid_t> m_pids;
+};
+
+
+#endif // GRAPH_WORKER_PROCESSES
+
+/**
+ * @brief Připojí k bufferu číslo v kódování varint.
+ * @param[in, out] data buffer
+ * @param[in] value kódované číslo
+ */
+void appendVarint(std::vector<uint8_t>& data, size_t value) {
+    while (value >= 0x80) {
+        data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<uint8_t>(value));
+}
+
+/**
+ * @brief Přečte z bufferu číslo v kódování varint.
+ * @param[in] data buffer
+ * @param[in, out] position pozice čtení, posune se za přečtené číslo
+ * @return přečtené číslo
+ * @exception runtime_error pokud je číslo useknuté nebo příliš dlouhé
+ */
+size_t readVarint(const std::vector<uint8_t>& data, size_t& position) {
+    size_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (position >= data.size()) {
+            throw std::runtime_error("Truncated change log");
+        }
+        uint8_t byte = data[position++];
+        value |= static_cast<size_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+
+    throw std::runtime_error("Corrupted change log");
+}
+
+/**
+ * @brief Omezená fronta bez zámků pro jednoho producenta a jednoho konzumenta.
+ *
+ * Plná fronta blokuje producenta (zpětný tlak), prázdná fronta blokuje
+ * konzumenta, dokud producent frontu neuzavře. Čekající strana nejprve
+ * krátce aktivně čeká s předáním procesoru ostatním vláknům a poté se
+ * uspí na podmínkové proměnné. Druhá strana zamyká mutex jen tehdy,
+ * když některá strana spí.
+ *
+ * @tparam T typ prvků fronty
+ */
+template<typename T>
+class SpscQueue {
+public:
+    /**
+     * @param[in] capacity maximální počet prvků ve frontě
+     */
+    explicit SpscQueue(size_t capacity) : m_slots(std::max<size_t>(capacity, 1) + 1) {}
+
+    /**
+     * @brief Vloží prvek, při plné frontě čeká.
+     * @param[in] value vkládaný prvek
+     * @return false pokud byla fronta mezitím zrušena
+     */
+    bool push(T&& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) % m_slots.size();
+        wait([&] {
+            return next != m_head.load() || m_aborted.load();
+        });
+        if (m_aborted.load()) {
+            return false;
+        }
+        m_slots[tail] = std::move(value);
+        m_tail.store(next);
+        wake();
+        return true;
+    }
+
+    /**
+     * @brief Odebere prvek, při prázdné frontě čeká na prvek nebo uzavření.
+     * @param[out] value odebraný prvek
+     * @return false pokud je fronta uzavřená a prázdná nebo zrušená
+     */
+    bool pop(T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        wait([&] {
+            return head != m_tail.load() || m_closed.load() || m_aborted.load();
+        });
+        // Producent uzavírá frontu až po posledním vložení, uzavřená fronta je tedy úplná
+        if (m_aborted.load() || head == m_tail.load()) {
+            return false;
+        }
+        value = std::move(m_slots[head]);
+        m_head.store((head + 1) % m_slots.size());
+        wake();
+        return true;
+    }
+
+    /** @brief Producent již nic nevloží. */
+    void close() {
+        m_closed.store(true);
+        wake();
+    }
+
+    /** @brief Zruší frontu, čekající strany se vrátí s neúspěchem. */
+    void abort() {
+        m_aborted.store(true);
+        wake();
+    }
+
+private:
+    /// počet pokusů aktivního čekání před uspáním vlákna
+    static constexpr size_t SPIN_LIMIT = 64;
+
+    /**
+     * @brief Čeká, dokud nebude splněna podmínka.
+     *
+     * Počítadlo spících se zvyšuje před poslední kontrolou podmínky a změny
+     * stavu fronty se čtou až po svém zápisu, takže buzení se neztratí.
+     *
+     * @param[in] ready podmínka, na kterou se čeká
+     */
+    template<typename Ready>
+    void wait(Ready ready) {
+        for (size_t spin = 0; spin < SPIN_LIMIT; ++spin) {
+            if (ready()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_sleepers;
+        m_condition.wait(lock, ready);
+        --m_sleepers;
+    }
+
+    /** @brief Probudí spící stranu po změně stavu fronty. */
+    void wake() {
+        if (m_sleepers.load() != 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_condition.notify_all();
+        }
+    }
+
+    std::vector<T> m_slots;
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+    std::atomic<bool> m_closed{false};
+    std::atomic<bool> m_aborted{false};
+    std::atomic<size_t> m_sleepers{0};
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
+
+/**
+ * @brief Fond vláken s frontou úloh pro každé vlákno a kradením práce.
+ *
+ * Metoda run rozdělí indexy úloh do front vláken a vrátí se teprve po jejich
+ * dokončení, slouží tak zároveň jako bariéra. Vlákno odebírá úlohy ze začátku
+ * své fronty, a když je prázdná, krade z konce front ostatních vláken.
+ * Volající vlákno se na práci podílí jako vlákno s indexem 0.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @brief Spustí pracovní vlákna.
+     * @param[in] threadCount celkový počet vláken včetně volajícího
+     */
+    explicit WorkStealingPool(size_t threadCount) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 1; i < threadCount; ++i) {
+            m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Vykoná úlohy 0 až @p taskCount - 1 a počká na jejich dokončení.
+     * @param[in] taskCount počet úloh
+     * @param[in] task funkce vykonávající úlohu s daným indexem
+     */
+    void run(size_t taskCount, const std::function<void(size_t)>& task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            for (size_t i = 0; i < taskCount; ++i) {
+                Queue& queue = *m_queues[i % m_queues.size()];
+                std::lock_guard<std::mutex> queueLock(queue.mutex);
+                queue.tasks.push_back(i);
+            }
+            m_remaining = taskCount;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        drain(0);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_remaining == 0 && m_busy == 0; });
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    void workerLoop(size_t index) {
+        size_t seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+                if (m_stop) {
+                    return;
+                }
+                seenGeneration = m_generation;
+                ++m_busy;
+            }
+
+            drain(index);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_busy;
+            }
+            m_done.notify_all();
+        }
+    }
+
+    void drain(size_t index) {
+        size_t task;
+        while (popOrSteal(index, task)) {
+            (*m_task)(task);
+            if (m_remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done.notify_all();
+            }
+        }
+    }
+
+    bool popOrSteal(size_t index, size_t& task) {
+        {
+            Queue& own = *m_queues[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = own.tasks.front();
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+
+        for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+            Queue& victim = *m_queues[(index + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(size_t)>* m_task = nullptr;
+    std::atomic<size_t> m_remaining{0};
+    size_t m_generation = 0;
+    size_t m_busy = 0;
+    bool m_stop = false;
+};
+
+/// počet hran, po kterých generátory vkládají hrany do grafu
+constexpr size_t GENERATOR_BATCH_SIZE = size_t(1) << 16;
+
+/**
+ * @brief Sbírá hrany generátoru a po dávkách je vkládá do grafu.
+ *
+ * Generátory vytváří každou hranu nejvýše jednou a bez smyček. Do grafu bez
+ * hran se proto dávky vkládají hromadně přes addDistinctEdges bez kontroly
+ * duplicit, do grafu s hranami přes addMultipleEdges.
+ */
+class GeneratedEdges {
+public:
+    /**
+     * @param[in, out] graph graf, do kterého se hrany přidají
+     */
+    explicit GeneratedEdges(Graph& graph) : m_graph(graph), m_distinct(graph.edgeCount() == 0) {
+        m_edges.reserve(GENERATOR_BATCH_SIZE);
+    }
+
+    /**
+     * @brief Přidá hranu do dávky, plnou dávku vloží do grafu.
+     * @param[in] a id prvního uzlu
+     * @param[in] b id druhého uzlu
+     */
+    void add(size_t a, size_t b) {
+        m_edges.emplace_back(a, b);
+        if (m_edges.size() == GENERATOR_BATCH_SIZE) {
+            flush();
+        }
+    }
+
+    /** @brief Vloží zbylé hrany dávky do grafu. */
+    void flush() {
+        if (m_distinct) {
+            m_graph.addDistinctEdges(m_edges);
+        } else {
+            m_graph.addMultipleEdges(m_edges);
+        }
+        m_edges.clear();
+    }
+
+private:
+    Graph& m_graph;
+    bool m_distinct;
+    std::vector<Edge> m_edges;
+};
+
+} // namespace
 
 Graph::Graph() {}
 
-Graph::~Graph() {
-    clear();
+Graph::~Graph() {
+    // Zánik grafu není změnou, kterou by měly repliky přehrát
+    m_changeLog = nullptr;
+    clear();
+}
+
+std::vector<Node*> Graph::nodes() {
+    std::vector<Node*> nodes;
+    nodes.reserve(m_nodes.size());
+
+    for (const auto& pair : m_nodes) {
+        nodes.push_back(pair.second);
+    }
+
+    return nodes;
+}
+
+std::vector<Edge> Graph::edges() const {
+    if (m_deadEdges == 0) {
+        return m_edges;
+    }
+
+    std::vector<Edge> edges;
+    edges.reserve(edgeCount());
+    for (size_t i = 0; i < m_edges.size(); ++i) {
+        if (!m_edgeDead[i]) {
+            edges.push_back(m_edges[i]);
+        }
+    }
+
+    return edges;
+}
+
+Node* Graph::addNode(size_t nodeId) {
+    // Kontrola, zda uzel již existuje
+    if (m_nodes.find(nodeId) != m_nodes.end()) {
+        return nullptr;
+    }
+
+    // Vytvoření nového uzlu
+    Node* newNode = new Node(nodeId);
+    m_nodes[nodeId] = newNode;
+
+    // Inicializace prázdného seznamu sousedů pro nový uzel
+    m_adjacency[nodeId] = std::vector<size_t>();
+
+    if (m_changeLog != nullptr) {
+        m_changeLog->record(GraphChangeLog::Operation::ADD_NODE, nodeId);
+    }
+
+    // Přidělení řádku bitové matice, po vyčerpání rezervy se matice sestaví znovu
+    if (m_dense.active()) {
+        if (m_nodes.size() > m_denseMaxNodes) {
+            m_dense = DenseMatrix();
+        } else if (m_dense.ids.size() < m_dense.stride * 64) {
+            m_dense.index[nodeId] = m_dense.ids.size();
+            m_dense.ids.push_back(nodeId);
+        } else {
+            buildDenseMatrix();
+        }
+    }
+    updateDenseMatrix();
+
+    return newNode;
+}
+
+bool Graph::addEdge(const Edge& edge) {
+    // Ignorování smyček
+    if (edge.a == edge.b) {
+        return false;
+    }
+
+    // Kontrola, zda hrana již existuje
+    if (containsEdge(edge)) {
+        return false;
+    }
+
+    // Přidání uzlů, pokud neexistují
+    if (m_nodes.find(edge.a) == m_nodes.end()) {
+        addNode(edge.a);
+    }
+
+    if (m_nodes.find(edge.b) == m_nodes.end()) {
+        addNode(edge.b);
+    }
+
+    // Přidání hrany
+    m_edges.push_back(edge);
+    if (m_lazyEdgeDeletion) {
+        m_edgeDead.push_back(false);
+        m_edgeIndex[edge] = m_edges.size() - 1;
+    }
+    if (m_changeLog != nullptr) {
+        m_changeLog->record(GraphChangeLog::Operation::ADD_EDGE, edge.a, edge.b);
+    }
+
+    // Aktualizace seznamů sousedů
+    insertNeighbor(m_adjacency[edge.a], edge.b);
+    insertNeighbor(m_adjacency[edge.b], edge.a);
+
+    if (m_dense.active()) {
+        m_dense.set(m_dense.index[edge.a], m_dense.index[edge.b]);
+    }
+    updateDenseMatrix();
+
+    return true;
+}
+
+void Graph::reserve(size_t nodeCount, size_t edgeCount) {
+    m_nodes.reserve(nodeCount);
+    m_adjacency.reserve(nodeCount);
+    m_edges.reserve(edgeCount);
+    if (m_lazyEdgeDeletion) {
+        m_edgeDead.reserve(edgeCount);
+        m_edgeIndex.reserve(edgeCount);
+    }
+}
+
+void Graph::addMultipleEdges(const std::vector<Edge>& edges) {
+    for (const Edge& edge : edges) {
+        addEdge(edge);
+    }
+}
+
+void Graph::addDistinctEdges(const std::vector<Edge>& edges) {
+    // Délky seřazených seznamů před dávkou, připojené konce se pak jen slijí
+    std::vector<std::pair<size_t, size_t>> sortedPrefix;
+    if (m_sortedAdjacency) {
+        for (const Edge& edge : edges) {
+            sortedPrefix.emplace_back(edge.a, 0);
+            sortedPrefix.emplace_back(edge.b, 0);
+        }
+        std::sort(sortedPrefix.begin(), sortedPrefix.end());
+        sortedPrefix.erase(std::unique(sortedPrefix.begin(), sortedPrefix.end()), sortedPrefix.end());
+        for (auto& entry : sortedPrefix) {
+            auto it = m_adjacency.find(entry.first);
+            entry.second = it != m_adjacency.end() ? it->second.size() : 0;
+        }
+    }
+
+    for (const Edge& edge : edges) {
+        if (m_nodes.find(edge.a) == m_nodes.end()) {
+            addNode(edge.a);
+        }
+        if (m_nodes.find(edge.b) == m_nodes.end()) {
+            addNode(edge.b);
+        }
+
+        m_edges.push_back(edge);
+        if (m_lazyEdgeDeletion) {
+            m_edgeDead.push_back(false);
+            m_edgeIndex[edge] = m_edges.size() - 1;
+        }
+        if (m_changeLog != nullptr) {
+            m_changeLog->record(GraphChangeLog::Operation::ADD_EDGE, edge.a, edge.b);
+        }
+
+        m_adjacency[edge.a].push_back(edge.b);
+        m_adjacency[edge.b].push_back(edge.a);
+
+        if (m_dense.active()) {
+            m_dense.set(m_dense.index[edge.a], m_dense.index[edge.b]);
+        }
+    }
+
+    // Generátory připojují sousedy většinou vzestupně, slití se pak přeskočí
+    for (const auto& entry : sortedPrefix) {
+        std::vector<size_t>& neighbors = m_adjacency[entry.first];
+        auto middle = neighbors.begin() + entry.second;
+        if (!std::is_sorted(middle, neighbors.end())) {
+            std::sort(middle, neighbors.end());
+        }
+        if (middle != neighbors.begin() && middle != neighbors.end() && *middle < *(middle - 1)) {
+            std::inplace_merge(neighbors.begin(), middle, neighbors.end());
+        }
+    }
+
+    updateDenseMatrix();
+}
+
+Node* Graph::getNode(size_t nodeId) {
+    auto it = m_nodes.find(nodeId);
+    if (it != m_nodes.end()) {
+        return it->second;
+    }
+
+    return nullptr;
+}
+
+bool Graph::containsEdge(const Edge& edge) const {
+    // Kontrola existence uzlů
+    auto itA = m_nodes.find(edge.a);
+    auto itB = m_nodes.find(edge.b);
+
+    if (itA == m_nodes.end() || itB == m_nodes.end()) {
+        return false;
+    }
+
+    if (m_dense.active()) {
+        return m_dense.test(m_dense.index.at(edge.a), m_dense.index.at(edge.b));
+    }
+
+    // Hledání hrany v kratším ze seznamů sousedů obou uzlů
+    const auto& neighborsA = m_adjacency.at(edge.a);
+    const auto& neighborsB = m_adjacency.at(edge.b);
+    if (neighborsA.size() <= neighborsB.size()) {
+        return hasNeighbor(neighborsA, edge.b);
+    }
+
+    return hasNeighbor(neighborsB, edge.a);
+}
+
+void Graph::removeNode(size_t nodeId) {
+    auto nodeIt = m_nodes.find(nodeId);
+    if (nodeIt == m_nodes.end()) {
+        throw std::out_of_range("Node does not exist");
+    }
+
+    if (m_changeLog != nullptr) {
+        m_changeLog->record(GraphChangeLog::Operation::REMOVE_NODE, nodeId);
+    }
+
+    // Vynulování řádku a sloupce uzlu v bitové matici, nastavené bity odpovídají sousedům
+    if (m_dense.active()) {
+        size_t i = m_dense.index.at(nodeId);
+        for (size_t neighborId : m_adjacency[nodeId]) {
+            m_dense.reset(i, m_dense.index.at(neighborId));
+        }
+    }
+
+    // V líném režimu se hrany uzlu najdou přes jeho seznam sousedů a jen se označí
+    if (m_lazyEdgeDeletion) {
+        for (size_t neighborId : m_adjacency[nodeId]) {
+            eraseNeighbor(m_adjacency[neighborId], nodeId);
+            markEdgeDead(m_edgeIndex.at(Edge(nodeId, neighborId)));
+        }
+    }
+
+    // Odstranění všech hran spojených s tímto uzlem
+    auto it = m_lazyEdgeDeletion ? m_edges.end() : m_edges.begin();
+    while (it != m_edges.end()) {
+        if (it->a == nodeId || it->b == nodeId) {
+            // Odstranění ze seznamu sousedů
+            if (it->a == nodeId) {
+                eraseNeighbor(m_adjacency[it->b], nodeId);
+            } else {
+                eraseNeighbor(m_adjacency[it->a], nodeId);
+            }
+
+            m_edgeColors.erase(*it);
+            it = m_edges.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Odstranění seznamu sousedů
+    m_adjacency.erase(nodeId);
+
+    // Uvolnění paměti uzlu a odstranění z mapy uzlů
+    delete nodeIt->second;
+    m_nodes.erase(nodeIt);
+
+    // Hustý index uzlu zůstane neobsazený až do příštího sestavení matice
+    if (m_dense.active()) {
+        m_dense.index.erase(nodeId);
+    }
+    updateDenseMatrix();
+}
+
+void Graph::removeEdge(const Edge& edge) {
+    if (!containsEdge(edge)) {
+        throw std::out_of_range("Edge does not exist");
+    }
+
+    if (m_changeLog != nullptr) {
+        m_changeLog->record(GraphChangeLog::Operation::REMOVE_EDGE, edge.a, edge.b);
+    }
+
+    // V líném režimu se hrana pouze označí jako odebraná
+    if (m_lazyEdgeDeletion) {
+        eraseNeighbor(m_adjacency[edge.a], edge.b);
+        eraseNeighbor(m_adjacency[edge.b], edge.a);
+        if (m_dense.active()) {
+            m_dense.reset(m_dense.index[edge.a], m_dense.index[edge.b]);
+        }
+
+        markEdgeDead(m_edgeIndex.at(edge));
+        shrinkDenseMatrix();
+        return;
+    }
+
+    // Odstranění hrany z vektoru hran
+    auto it = m_edges.begin();
+    while (it != m_edges.end()) {
+        if (*it == edge) {
+            // Odstranění ze seznamu sousedů
+            eraseNeighbor(m_adjacency[it->a], it->b);
+            eraseNeighbor(m_adjacency[it->b], it->a);
+            if (m_dense.active()) {
+                m_dense.reset(m_dense.index[it->a], m_dense.index[it->b]);
+            }
+
+            m_edgeColors.erase(*it);
+            it = m_edges.erase(it);
+            shrinkDenseMatrix();
+            return;
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t Graph::nodeCount() const {
+    return m_nodes.size();
+}
+
+size_t Graph::edgeCount() const {
+    return m_edges.size() - m_deadEdges;
+}
+
+size_t Graph::nodeDegree(size_t nodeId) const {
+    auto it = m_adjacency.find(nodeId);
+    if (it == m_adjacency.end()) {
+        throw std::out_of_range("Node does not exist");
+    }
+
+    return it->second.size();
+}
+
+size_t Graph::graphDegree() const {
+    if (m_nodes.empty()) {
+        return 0;
+    }
+
+    size_t maxDegree = 0;
+    for (const auto& pair : m_adjacency) {
+        maxDegree = std::max(maxDegree, pair.second.size());
+    }
+
+    return maxDegree;
+}
+
+void Graph::coloring() {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    // Implementace greedy barvení grafu
+    // Nejprve seřadíme uzly podle stupně (sestupně), stupně zjistíme jen jednou
+    std::vector<std::pair<size_t, Node*>> order;
+    order.reserve(m_nodes.size());
+
+    ColorSnapshot previous = snapshotColors();
+    for (const auto& pair : m_nodes) {
+        order.emplace_back(m_adjacency[pair.first].size(), pair.second);
+        pair.second->color = 0;
+    }
+
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second->id < b.second->id;
+    });
+
+    if (m_dense.active()) {
+        denseColoring(order);
+        logColors(previous);
+        return;
+    }
+
+    // Pro každý uzel najdeme první dostupnou barvu
+    // Barvy číslujeme od 1, 0 znamená neobarveno
+    ColorMask usedColors;
+    for (const auto& entry : order) {
+        size_t degree = entry.first;
+        Node* node = entry.second;
+
+        // Sbíráme barvy sousedů, uzlu stupně d stačí barvy 1 až d + 1
+        usedColors.prepare(degree + 1);
+        for (size_t neighborId : m_adjacency[node->id]) {
+            usedColors.mark(m_nodes[neighborId]->color);
+        }
+
+        node->color = usedColors.firstFree();
+    }
+
+    logColors(previous);
+}
+
+size_t Graph::improveColoring(size_t maxIterations, std::chrono::milliseconds timeBudget, size_t threadCount) {
+    if (maxIterations == 0 && timeBudget.count() <= 0) {
+        throw std::invalid_argument("Iteration count or time budget must be set");
+    }
+
+    if (m_nodes.empty()) {
+        return 0;
+    }
+
+    CompactAdjacency adjacency = compactAdjacency();
+    const auto& offsets = adjacency.offsets;
+    const auto& targets = adjacency.targets;
+
+    std::vector<size_t> best(adjacency.nodes.size());
+    for (size_t v = 0; v < best.size(); ++v) {
+        best[v] = adjacency.nodes[v]->color;
+    }
+
+    // Vycházíme z platného obarvení, jinak jej nejprve vytvoříme
+    if (!isValidColoring(offsets, targets, best)) {
+        coloring();
+        for (size_t v = 0; v < best.size(); ++v) {
+            best[v] = adjacency.nodes[v]->color;
+        }
+    }
+    size_t bestCount = *std::max_element(best.begin(), best.end());
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeBudget;
+    std::atomic<size_t> iterations(0);
+    std::mutex bestMutex;
+
+    auto worker = [&](size_t threadIndex) {
+        std::mt19937_64 engine(threadIndex + 1);
+        ColorMask mask;
+        KempeScratch scratch;
+        scratch.stamp.assign(adjacency.nodes.size(), 0);
+        StepDeadline stepDeadline(timeBudget.count() > 0, deadline);
+
+        std::vector<size_t> colors;
+        {
+            std::lock_guard<std::mutex> lock(bestMutex);
+            colors = best;
+        }
+
+        while (true) {
+            size_t iteration = iterations.fetch_add(1);
+            if (maxIterations != 0 && iteration >= maxIterations) {
+                break;
+            }
+            if (timeBudget.count() > 0 && std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+
+            if (!iteratedGreedyStep(offsets, targets, colors, (iteration + threadIndex) % 4,
+                                    engine, mask, stepDeadline)) {
+                // Neúplné obarvení přerušeného kroku zahodíme
+                break;
+            }
+
+            // Pokus o vyprázdnění nejvyšší třídy barev, každé přebarvení zachovává platnost
+            size_t colorCount = *std::max_element(colors.begin(), colors.end());
+            for (size_t v = 0; v < colors.size() && !stepDeadline.expired(); ++v) {
+                if (colors[v] == colorCount) {
+                    kempeRecolor(offsets, targets, colors, v, colorCount, mask, scratch, stepDeadline);
+                }
+            }
+            colorCount = *std::max_element(colors.begin(), colors.end());
+
+            std::lock_guard<std::mutex> lock(bestMutex);
+            if (colorCount < bestCount) {
+                best = colors;
+                bestCount = colorCount;
+            } else if (colorCount > bestCount) {
+                colors = best;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Do uzlů zapíšeme pouze ověřené obarvení
+    if (isValidColoring(offsets, targets, best)) {
+        ColorSnapshot previous = snapshotColors(adjacency.nodes);
+        for (size_t v = 0; v < best.size(); ++v) {
+            adjacency.nodes[v]->color = best[v];
+        }
+        logColors(previous);
+    }
+
+    return *std::max_element(best.begin(), best.end());
+}
+
+void Graph::distance2Coloring(size_t threadCount) {
+    std::vector<size_t> nodeIds;
+    nodeIds.reserve(m_nodes.size());
+    for (const auto& pair : m_nodes) {
+        nodeIds.push_back(pair.first);
+    }
+
+    partialDistance2Coloring(nodeIds, threadCount);
+}
+
+void Graph::partialDistance2Coloring(const std::vector<size_t>& nodeIds, size_t threadCount) {
+    for (size_t nodeId : nodeIds) {
+        if (m_nodes.find(nodeId) == m_nodes.end()) {
+            throw std::out_of_range("Node does not exist");
+        }
+    }
+
+    if (nodeIds.empty()) {
+        return;
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    CompactAdjacency adjacency = compactAdjacency();
+    std::vector<char> member(adjacency.nodes.size(), 0);
+    std::set<size_t> selected(nodeIds.begin(), nodeIds.end());
+    for (size_t v = 0; v < adjacency.nodes.size(); ++v) {
+        member[v] = selected.count(adjacency.nodes[v]->id) != 0;
+    }
+
+    std::vector<size_t> colors = distance2Colors(adjacency.offsets, adjacency.targets, member, threadCount);
+    std::vector<Node*> colored;
+    colored.reserve(nodeIds.size());
+    for (size_t v = 0; v < adjacency.nodes.size(); ++v) {
+        if (member[v]) {
+            colored.push_back(adjacency.nodes[v]);
+        }
+    }
+
+    ColorSnapshot previous = snapshotColors(colored);
+    for (size_t v = 0; v < adjacency.nodes.size(); ++v) {
+        if (member[v]) {
+            adjacency.nodes[v]->color = colors[v];
+        }
+    }
+    logColors(previous);
+}
+
+std::vector<DistributedRoundStats> Graph::distributedColoring(size_t workerCount) {
+    if (workerCount == 0) {
+        throw std::invalid_argument("Worker count must be positive");
+    }
+
+    std::vector<DistributedRoundStats> stats;
+    if (m_nodes.empty()) {
+        return stats;
+    }
+
+#ifndef GRAPH_WORKER_PROCESSES
+    throw std::runtime_error("Worker processes are not supported on this platform");
+#else
+    CompactAdjacency adjacency = compactAdjacency();
+    const auto& offsets = adjacency.offsets;
+    const auto& targets = adjacency.targets;
+    size_t nodeCount = adjacency.nodes.size();
+
+    // Souvislé oddíly podle id, uzly jsou v kompaktní sousednosti seřazeny podle id
+    size_t partSize = (nodeCount + workerCount - 1) / workerCount;
+    auto ownerOf = [partSize](size_t v) {
+        return v / partSize;
+    };
+
+    // Při výjimce destruktor zavře sokety a počká na všechny již spuštěné procesy
+    WorkerProcesses workers;
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        workers.start();
+    }
+
+    std::vector<size_t> colors(nodeCount, 0);
+    // Rozeslání oddílů
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        std::vector<uint64_t> partition;
+        for (size_t v = worker * partSize; v < std::min(nodeCount, (worker + 1) * partSize); ++v) {
+            partition.push_back(v);
+            partition.push_back(offsets[v + 1] - offsets[v]);
+            partition.insert(partition.end(), targets.begin() + offsets[v], targets.begin() + offsets[v + 1]);
+        }
+        sendMessage(workers.socket(worker), partition);
+    }
+
+    std::vector<std::vector<uint64_t>> outgoing(workerCount, std::vector<uint64_t>{1});
+    std::vector<uint64_t> incoming;
+    for (size_t round = 1;; ++round) {
+        DistributedRoundStats roundStats{round, 0, 0, 0, 0};
+        for (size_t worker = 0; worker < workerCount; ++worker) {
+            roundStats.bytesSent += sendMessage(workers.socket(worker), outgoing[worker]);
+            outgoing[worker].assign(1, 1);
+        }
+
+        std::vector<size_t> changed;
+        for (size_t worker = 0; worker < workerCount; ++worker) {
+            roundStats.bytesReceived += receiveMessage(workers.socket(worker), incoming);
+            for (size_t i = 0; i + 1 < incoming.size(); i += 2) {
+                colors[incoming[i]] = incoming[i + 1];
+                changed.push_back(incoming[i]);
+            }
+        }
+        roundStats.messages = 2 * workerCount;
+
+        // Konflikty na hranách mezi oddíly, přebarvuje se uzel s vyšším id
+        std::vector<size_t> reset;
+        for (size_t v : changed) {
+            for (size_t i = offsets[v]; i < offsets[v + 1] && colors[v] != 0; ++i) {
+                size_t w = targets[i];
+                if (ownerOf(w) != ownerOf(v) && colors[w] == colors[v]) {
+                    size_t loser = std::max(v, w);
+                    colors[loser] = 0;
+                    reset.push_back(loser);
+                    ++roundStats.conflicts;
+                }
+            }
+        }
+        changed.insert(changed.end(), reset.begin(), reset.end());
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+        // Změněné barvy dostanou procesy se sousedy uzlu, pokyn k přebarvení vlastník
+        std::vector<size_t> lastWorker(workerCount, static_cast<size_t>(-1));
+        for (size_t v : changed) {
+            if (colors[v] == 0) {
+                outgoing[ownerOf(v)].push_back(v);
+                outgoing[ownerOf(v)].push_back(0);
+            }
+            for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                size_t worker = ownerOf(targets[i]);
+                if (worker != ownerOf(v) && lastWorker[worker] != v) {
+                    lastWorker[worker] = v;
+                    outgoing[worker].push_back(v);
+                    outgoing[worker].push_back(colors[v]);
+                }
+            }
+        }
+
+        stats.push_back(roundStats);
+        if (reset.empty()) {
+            break;
+        }
+    }
+
+    // Závěrečná zpráva, procesy vrátí barvy všech svých uzlů
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        outgoing[worker][0] = 0;
+        sendMessage(workers.socket(worker), outgoing[worker]);
+    }
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        receiveMessage(workers.socket(worker), incoming);
+        for (size_t i = 0; i + 1 < incoming.size(); i += 2) {
+            colors[incoming[i]] = incoming[i + 1];
+        }
+    }
+
+    if (!workers.finish()) {
+        throw std::runtime_error("Worker process failed");
+    }
+
+    ColorSnapshot previous = snapshotColors(adjacency.nodes);
+    for (size_t v = 0; v < nodeCount; ++v) {
+        adjacency.nodes[v]->color = colors[v];
+    }
+    logColors(previous);
+
+    return stats;
+#endif
+}
+
+std::vector<std::vector<Edge>> Graph::edgeColoring(EdgeColoringMethod method) {
+    compactEdges();
+    m_edgeColors.clear();
+    if (m_edges.empty()) {
+        return {};
+    }
+
+    // Barvy se počítají podle pozice hrany, do mapy barev se zapíší na konci
+    std::vector<size_t> colors(m_edges.size(), 0);
+
+    std::unordered_map<size_t, size_t> denseIndex;
+    denseIndex.reserve(m_nodes.size());
+    for (const auto& pair : m_nodes) {
+        denseIndex.emplace(pair.first, denseIndex.size());
+    }
+
+    size_t colorCount = 0;
+    if (method == EdgeColoringMethod::MISRA_GRIES) {
+        colorCount = graphDegree() + 1;
+        EdgeColorTable table(m_nodes.size(), colorCount);
+        std::vector<char> inFan(m_nodes.size(), 0);
+        for (const Edge& edge : m_edges) {
+            misraGriesColorEdge(table, colorCount, denseIndex[edge.a], denseIndex[edge.b], inFan);
+        }
+
+        for (size_t i = 0; i < m_edges.size(); ++i) {
+            colors[i] = table.colorOf(denseIndex[m_edges[i].a], denseIndex[m_edges[i].b]) + 1;
+        }
+    } else {
+        // Hrana dostane nejmenší barvu volnou na obou koncových uzlech
+        std::vector<std::vector<uint64_t>> used(m_nodes.size());
+        for (size_t i = 0; i < m_edges.size(); ++i) {
+            auto& usedA = used[denseIndex[m_edges[i].a]];
+            auto& usedB = used[denseIndex[m_edges[i].b]];
+            size_t color = 0;
+            for (size_t word = 0;; ++word) {
+                uint64_t taken = (word < usedA.size() ? usedA[word] : 0) | (word < usedB.size() ? usedB[word] : 0);
+                if (~taken != 0) {
+                    color = word * 64 + countTrailingZeros(~taken);
+                    break;
+                }
+            }
+
+            for (auto* mask : {&usedA, &usedB}) {
+                if (mask->size() <= color / 64) {
+                    mask->resize(color / 64 + 1, 0);
+                }
+                (*mask)[color / 64] |= uint64_t(1) << (color % 64);
+            }
+            colors[i] = color + 1;
+            colorCount = std::max(colorCount, color + 1);
+        }
+    }
+
+    std::vector<std::vector<Edge>> matchings(colorCount);
+    m_edgeColors.reserve(m_edges.size());
+    for (size_t i = 0; i < m_edges.size(); ++i) {
+        matchings[colors[i] - 1].push_back(m_edges[i]);
+        m_edgeColors.emplace(m_edges[i], colors[i]);
+    }
+
+    // Nepoužité barvy na konci nevracíme
+    while (!matchings.empty() && matchings.back().empty()) {
+        matchings.pop_back();
+    }
+
+    return matchings;
+}
+
+size_t Graph::edgeColor(const Edge& edge) const {
+    auto it = m_edgeColors.find(edge);
+    if (it != m_edgeColors.end()) {
+        return it->second;
+    }
+
+    // Hrana bez barvy je neobarvená, pokud v grafu existuje
+    if (!containsEdge(edge)) {
+        throw std::out_of_range("Edge does not exist");
+    }
+
+    return 0;
+}
+
+std::vector<ColorPhaseStats> Graph::executeByColor(const std::function<void(Node*)>& task,
+                                                   size_t threadCount, size_t grainSize) {
+    std::vector<ColorPhaseStats> stats;
+    if (m_nodes.empty()) {
+        return stats;
+    }
+
+    bool colored = std::all_of(m_nodes.begin(), m_nodes.end(), [](const auto& pair) {
+        return pair.second->color != 0;
+    });
+    if (!colored) {
+        coloring();
+    }
+
+    // Rozdělení uzlů do tříd podle barvy, uvnitř třídy podle id
+    std::vector<Node*> nodes;
+    nodes.reserve(m_nodes.size());
+    for (const auto& pair : m_nodes) {
+        nodes.push_back(pair.second);
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const Node* a, const Node* b) {
+        return a->color != b->color ? a->color < b->color : a->id < b->id;
+    });
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    WorkStealingPool pool(threadCount);
+    for (size_t begin = 0; begin < nodes.size();) {
+        size_t end = begin;
+        while (end < nodes.size() && nodes[end]->color == nodes[begin]->color) {
+            ++end;
+        }
+
+        size_t classSize = end - begin;
+        size_t chunkCount = (classSize + grainSize - 1) / grainSize;
+        auto start = std::chrono::steady_clock::now();
+        pool.run(chunkCount, [&](size_t chunk) {
+            size_t chunkBegin = begin + chunk * grainSize;
+            size_t chunkEnd = std::min(chunkBegin + grainSize, end);
+            for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+                task(nodes[i]);
+            }
+        });
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        stats.push_back({nodes[begin]->color, classSize,
+                         std::chrono::duration_cast<std::chrono::nanoseconds>(duration)});
+        begin = end;
+    }
+
+    return stats;
+}
+
+void Graph::clear() {
+    // Uvolnění paměti všech uzlů
+    for (auto& pair : m_nodes) {
+        delete pair.second;
+    }
+
+    if (m_changeLog != nullptr) {
+        m_changeLog->record(GraphChangeLog::Operation::CLEAR);
+    }
+
+    // Vyčištění datových struktur
+    m_nodes.clear();
+    m_edges.clear();
+    m_edgeColors.clear();
+    m_edgeDead.clear();
+    m_deadEdges = 0;
+    m_edgeIndex.clear();
+    m_adjacency.clear();
+    m_dense = DenseMatrix();
+}
+
+void Graph::attachChangeLog(GraphChangeLog* log) {
+    m_changeLog = log;
+}
+
+Graph::ColorSnapshot Graph::snapshotColors() const {
+    ColorSnapshot snapshot;
+    if (m_changeLog == nullptr) {
+        return snapshot;
+    }
+
+    snapshot.reserve(m_nodes.size());
+    for (const auto& pair : m_nodes) {
+        snapshot.emplace_back(pair.second, pair.second->color);
+    }
+
+    return snapshot;
+}
+
+Graph::ColorSnapshot Graph::snapshotColors(const std::vector<Node*>& nodes) const {
+    ColorSnapshot snapshot;
+    if (m_changeLog == nullptr) {
+        return snapshot;
+    }
+
+    snapshot.reserve(nodes.size());
+    for (Node* node : nodes) {
+        snapshot.emplace_back(node, node->color);
+    }
+
+    return snapshot;
+}
+
+void Graph::logColors(const ColorSnapshot& snapshot) {
+    if (m_changeLog == nullptr) {
+        return;
+    }
+
+    // Opakované barvení většinou přidělí stejné barvy, zapisují se jen změny
+    for (const auto& entry : snapshot) {
+        if (entry.first->color != entry.second) {
+            m_changeLog->record(GraphChangeLog::Operation::SET_COLOR, entry.first->id, entry.first->color);
+        }
+    }
+}
+
+void Graph::setSortedAdjacency(bool sorted) {
+    if (sorted && !m_sortedAdjacency) {
+        for (auto& pair : m_adjacency) {
+            std::sort(pair.second.begin(), pair.second.end());
+        }
+    }
+
+    m_sortedAdjacency = sorted;
+}
+
+bool Graph::sortedAdjacency() const {
+    return m_sortedAdjacency;
+}
+
+void Graph::setLazyEdgeDeletion(bool enabled, double compactionRatio) {
+    if (!(compactionRatio > 0.0 && compactionRatio <= 1.0)) {
+        throw std::invalid_argument("Compaction ratio must be in (0, 1]");
+    }
+
+    m_compactionRatio = compactionRatio;
+    if (enabled == m_lazyEdgeDeletion) {
+        return;
+    }
+
+    compactEdges();
+    m_lazyEdgeDeletion = enabled;
+    m_edgeIndex.clear();
+    std::vector<bool>().swap(m_edgeDead);
+    if (enabled) {
+        m_edgeDead.assign(m_edges.size(), false);
+        m_edgeIndex.reserve(m_edges.size());
+        for (size_t i = 0; i < m_edges.size(); ++i) {
+            m_edgeIndex[m_edges[i]] = i;
+        }
+    }
+}
+
+bool Graph::lazyEdgeDeletion() const {
+    return m_lazyEdgeDeletion;
+}
+
+void Graph::compactEdges() {
+    if (m_deadEdges == 0) {
+        return;
+    }
+
+    // Živé hrany se posunou na začátek se zachováním pořadí
+    size_t kept = 0;
+    for (size_t i = 0; i < m_edges.size(); ++i) {
+        if (m_edgeDead[i]) {
+            continue;
+        }
+        if (kept != i) {
+            m_edges[kept] = m_edges[i];
+            if (m_lazyEdgeDeletion) {
+                m_edgeIndex[m_edges[kept]] = kept;
+            }
+        }
+        ++kept;
+    }
+
+    m_edges.erase(m_edges.begin() + kept, m_edges.end());
+    m_edgeDead.assign(kept, false);
+    m_deadEdges = 0;
+}
+
+void Graph::markEdgeDead(size_t index) {
+    m_edgeIndex.erase(m_edges[index]);
+    m_edgeColors.erase(m_edges[index]);
+    m_edgeDead[index] = true;
+    ++m_deadEdges;
+
+    // Zhutnění po překročení podílu odebraných hran rozloží svou cenu mezi odebrání
+    if (m_deadEdges > m_compactionRatio * m_edges.size()) {
+        compactEdges();
+    }
+}
+
+void Graph::setDenseMatrixPolicy(double densityThreshold, size_t maxNodes) {
+    if (!(densityThreshold > 0.0 && densityThreshold <= 1.0)) {
+        throw std::invalid_argument("Density threshold must be in (0, 1]");
+    }
+
+    m_denseThreshold = densityThreshold;
+    m_denseMaxNodes = maxNodes;
+    m_dense = DenseMatrix();
+    updateDenseMatrix();
+}
+
+bool Graph::denseMatrixActive() const {
+    return m_dense.active();
+}
+
+std::vector<size_t> Graph::commonNeighbors(size_t a, size_t b) const {
+    auto itA = m_adjacency.find(a);
+    auto itB = m_adjacency.find(b);
+    if (itA == m_adjacency.end() || itB == m_adjacency.end()) {
+        throw std::out_of_range("Node does not exist");
+    }
+
+    std::vector<size_t> common;
+    common.reserve(std::min(itA->second.size(), itB->second.size()));
+
+    if (m_dense.active()) {
+        const uint64_t* rowA = m_dense.row(m_dense.index.at(a));
+        const uint64_t* rowB = m_dense.row(m_dense.index.at(b));
+        for (size_t word = 0; word < m_dense.stride; ++word) {
+            uint64_t bits = rowA[word] & rowB[word];
+            while (bits != 0) {
+                common.push_back(m_dense.ids[word * 64 + countTrailingZeros(bits)]);
+                bits &= bits - 1;
+            }
+        }
+        std::sort(common.begin(), common.end());
+        return common;
+    }
+
+    if (m_sortedAdjacency) {
+        std::set_intersection(itA->second.begin(), itA->second.end(),
+                              itB->second.begin(), itB->second.end(),
+                              std::back_inserter(common));
+        return common;
+    }
+
+    // Neseřazené seznamy je nutné pro slití nejprve seřadit
+    std::vector<size_t> neighborsA(itA->second);
+    std::vector<size_t> neighborsB(itB->second);
+    std::sort(neighborsA.begin(), neighborsA.end());
+    std::sort(neighborsB.begin(), neighborsB.end());
+    std::set_intersection(neighborsA.begin(), neighborsA.end(),
+                          neighborsB.begin(), neighborsB.end(),
+                          std::back_inserter(common));
+
+    return common;
+}
+
+size_t Graph::triangleCount() const {
+    // S bitovou maticí je každý trojúhelník započten jednou za každou ze svých tří hran
+    if (m_dense.active()) {
+        size_t triangles = 0;
+        for (const Edge& edge : edges()) {
+            triangles += bitsIntersectionCount(m_dense.row(m_dense.index.at(edge.a)),
+                                               m_dense.row(m_dense.index.at(edge.b)), m_dense.stride);
+        }
+        return triangles / 3;
+    }
+
+    // Uzly seřadíme podle stupně (při shodě podle id), pořadí určuje orientaci hran
+    std::vector<size_t> nodeIds;
+    nodeIds.reserve(m_adjacency.size());
+    for (const auto& pair : m_adjacency) {
+        nodeIds.push_back(pair.first);
+    }
+
+    std::sort(nodeIds.begin(), nodeIds.end(), [this](size_t a, size_t b) {
+        size_t degreeA = m_adjacency.at(a).size();
+        size_t degreeB = m_adjacency.at(b).size();
+        return degreeA != degreeB ? degreeA < degreeB : a < b;
+    });
+
+    std::unordered_map<size_t, size_t> rank;
+    rank.reserve(nodeIds.size());
+    for (size_t i = 0; i < nodeIds.size(); ++i) {
+        rank[nodeIds[i]] = i;
+    }
+
+    // Výstupní seznam uzlu obsahuje pouze sousedy s vyšším pořadím
+    std::vector<std::vector<size_t>> outgoing(nodeIds.size());
+    for (size_t i = 0; i < nodeIds.size(); ++i) {
+        for (size_t neighborId : m_adjacency.at(nodeIds[i])) {
+            size_t neighborRank = rank[neighborId];
+            if (neighborRank > i) {
+                outgoing[i].push_back(neighborRank);
+            }
+        }
+        std::sort(outgoing[i].begin(), outgoing[i].end());
+    }
+
+    // Trojúhelník u < v < w je nalezen právě jednou při průniku out(u) a out(v)
+    size_t triangles = 0;
+    for (size_t u = 0; u < outgoing.size(); ++u) {
+        for (size_t v : outgoing[u]) {
+            auto itU = outgoing[u].begin();
+            auto itV = outgoing[v].begin();
+            while (itU != outgoing[u].end() && itV != outgoing[v].end()) {
+                if (*itU < *itV) {
+                    ++itU;
+                } else if (*itV < *itU) {
+                    ++itV;
+                } else {
+                    ++triangles;
+                    ++itU;
+                    ++itV;
+                }
+            }
+        }
+    }
+
+    return triangles;
+}
+
+Graph::CompactAdjacency Graph::compactAdjacency() const {
+    CompactAdjacency adjacency;
+    adjacency.nodes.reserve(m_nodes.size());
+    for (const auto& pair : m_nodes) {
+        adjacency.nodes.push_back(pair.second);
+    }
+    std::sort(adjacency.nodes.begin(), adjacency.nodes.end(), [](const Node* a, const Node* b) {
+        return a->id < b->id;
+    });
+
+    std::unordered_map<size_t, size_t> denseIndex;
+    denseIndex.reserve(adjacency.nodes.size());
+    for (size_t i = 0; i < adjacency.nodes.size(); ++i) {
+        denseIndex[adjacency.nodes[i]->id] = i;
+    }
+
+    adjacency.offsets.reserve(adjacency.nodes.size() + 1);
+    adjacency.targets.reserve(2 * edgeCount());
+    adjacency.offsets.push_back(0);
+    for (const Node* node : adjacency.nodes) {
+        for (size_t neighborId : m_adjacency.at(node->id)) {
+            adjacency.targets.push_back(denseIndex[neighborId]);
+        }
+        adjacency.offsets.push_back(adjacency.targets.size());
+    }
+
+    return adjacency;
+}
+
+void Graph::buildDenseMatrix() {
+    // Rezerva polovinu aktuálního počtu uzlů, aby přidávání uzlů nevyvolávalo časté přestavby
+    size_t capacity = std::min(m_denseMaxNodes, m_nodes.size() + m_nodes.size() / 2);
+
+    DenseMatrix dense;
+    dense.stride = capacity / 64 + 1;
+    dense.bits.assign(dense.stride * dense.stride * 64, 0);
+    dense.ids.reserve(capacity);
+    dense.index.reserve(capacity);
+    for (const auto& pair : m_nodes) {
+        dense.ids.push_back(pair.first);
+    }
+    std::sort(dense.ids.begin(), dense.ids.end());
+    for (size_t i = 0; i < dense.ids.size(); ++i) {
+        dense.index[dense.ids[i]] = i;
+    }
+
+    for (size_t i = 0; i < m_edges.size(); ++i) {
+        if (m_deadEdges == 0 || !m_edgeDead[i]) {
+            dense.set(dense.index[m_edges[i].a], dense.index[m_edges[i].b]);
+        }
+    }
+
+    m_dense = std::move(dense);
+}
+
+void Graph::updateDenseMatrix() {
+    size_t n = m_nodes.size();
+    if (n < DENSE_MATRIX_MIN_NODES || n > m_denseMaxNodes) {
+        if (m_dense.active()) {
+            m_dense = DenseMatrix();
+        }
+        return;
+    }
+
+    // Hystereze brání opakovanému sestavování a rušení matice kolem prahu
+    if (m_dense.active()) {
+        shrinkDenseMatrix();
+    } else if (edgeDensity() >= m_denseThreshold) {
+        buildDenseMatrix();
+    }
+}
+
+double Graph::edgeDensity() const {
+    double n = static_cast<double>(m_nodes.size());
+    if (n < 2) {
+        return 0.0;
+    }
+
+    return 2.0 * static_cast<double>(edgeCount()) / (n * (n - 1));
+}
+
+void Graph::shrinkDenseMatrix() {
+    if (m_dense.active() && edgeDensity() < m_denseThreshold / 2) {
+        m_dense = DenseMatrix();
+    }
+}
+
+void Graph::denseColoring(const std::vector<std::pair<size_t, Node*>>& order) {
+    // Bitová množina uzlů každé barvy, barva c + 1 odpovídá prvku c
+    std::vector<std::vector<uint64_t>> colorClasses;
+
+    for (const auto& entry : order) {
+        Node* node = entry.second;
+        size_t i = m_dense.index.at(node->id);
+        const uint64_t* row = m_dense.row(i);
+
+        // Uzel dostane první barvu, jejíž třída nemá průnik s řádkem uzlu
+        size_t color = 0;
+        while (color < colorClasses.size() && bitsIntersect(row, colorClasses[color].data(), m_dense.stride)) {
+            ++color;
+        }
+        if (color == colorClasses.size()) {
+            colorClasses.emplace_back(m_dense.stride, 0);
+        }
+
+        colorClasses[color][i >> 6] |= uint64_t(1) << (i & 63);
+        node->color = color + 1;
+    }
+}
+
+bool Graph::hasNeighbor(const std::vector<size_t>& neighbors, size_t nodeId) const {
+    if (m_sortedAdjacency) {
+        return std::binary_search(neighbors.begin(), neighbors.end(), nodeId);
+    }
+
+    return std::find(neighbors.begin(), neighbors.end(), nodeId) != neighbors.end();
+}
+
+void Graph::insertNeighbor(std::vector<size_t>& neighbors, size_t nodeId) {
+    if (m_sortedAdjacency) {
+        neighbors.insert(std::lower_bound(neighbors.begin(), neighbors.end(), nodeId), nodeId);
+    } else {
+        neighbors.push_back(nodeId);
+    }
+}
+
+void Graph::eraseNeighbor(std::vector<size_t>& neighbors, size_t nodeId) {
+    if (m_sortedAdjacency) {
+        auto it = std::lower_bound(neighbors.begin(), neighbors.end(), nodeId);
+        if (it != neighbors.end() && *it == nodeId) {
+            neighbors.erase(it);
+        }
+    } else {
+        neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), nodeId), neighbors.end());
+    }
+}
+
+void GraphChangeLog::record(Operation operation, size_t first, size_t second) {
+    m_data.push_back(static_cast<uint8_t>(operation));
+    switch (operation) {
+        case Operation::ADD_EDGE:
+        case Operation::REMOVE_EDGE:
+        case Operation::SET_COLOR:
+            appendVarint(m_data, first);
+            appendVarint(m_data, second);
+            break;
+        case Operation::ADD_NODE:
+        case Operation::REMOVE_NODE:
+            appendVarint(m_data, first);
+            break;
+        case Operation::CLEAR:
+            break;
+    }
+}
+
+size_t GraphChangeLog::offset() const {
+    return m_baseOffset + m_data.size();
+}
+
+size_t GraphChangeLog::baseOffset() const {
+    return m_baseOffset;
+}
+
+std::vector<uint8_t> GraphChangeLog::read(size_t fromOffset) const {
+    if (fromOffset < m_baseOffset || fromOffset > offset()) {
+        throw std::out_of_range("Offset is not available in change log");
+    }
+
+    return std::vector<uint8_t>(m_data.begin() + (fromOffset - m_baseOffset), m_data.end());
+}
+
+size_t GraphChangeLog::replay(Graph& graph, size_t fromOffset) const {
+    apply(graph, read(fromOffset));
+    return offset();
+}
+
+void GraphChangeLog::compact(size_t offset) {
+    if (offset < m_baseOffset || offset > this->offset()) {
+        throw std::out_of_range("Offset is not available in change log");
+    }
+
+    m_data.erase(m_data.begin(), m_data.begin() + (offset - m_baseOffset));
+    m_baseOffset = offset;
+}
+
+std::vector<uint8_t> GraphChangeLog::snapshot(Graph& graph) {
+    GraphChangeLog log;
+    log.record(Operation::CLEAR);
+
+    // Uzly zapisujeme podle id, aby byl snímek stejného grafu vždy stejný
+    std::vector<Node*> nodes = graph.nodes();
+    std::sort(nodes.begin(), nodes.end(), [](const Node* a, const Node* b) {
+        return a->id < b->id;
+    });
+    for (const Node* node : nodes) {
+        log.record(Operation::ADD_NODE, node->id);
+    }
+    for (const Edge& edge : graph.edges()) {
+        log.record(Operation::ADD_EDGE, edge.a, edge.b);
+    }
+    for (const Node* node : nodes) {
+        if (node->color != 0) {
+            log.record(Operation::SET_COLOR, node->id, node->color);
+        }
+    }
+
+    return std::move(log.m_data);
+}
+
+void GraphChangeLog::apply(Graph& graph, const std::vector<uint8_t>& data) {
+    size_t position = 0;
+    while (position < data.size()) {
+        Operation operation = static_cast<Operation>(data[position++]);
+        switch (operation) {
+            case Operation::ADD_NODE:
+                graph.addNode(readVarint(data, position));
+                break;
+            case Operation::ADD_EDGE: {
+                size_t a = readVarint(data, position);
+                size_t b = readVarint(data, position);
+                graph.addEdge(Edge(a, b));
+                break;
+            }
+            case Operation::REMOVE_NODE:
+                graph.removeNode(readVarint(data, position));
+                break;
+            case Operation::REMOVE_EDGE: {
+                size_t a = readVarint(data, position);
+                size_t b = readVarint(data, position);
+                graph.removeEdge(Edge(a, b));
+                break;
+            }
+            case Operation::SET_COLOR: {
+                size_t nodeId = readVarint(data, position);
+                size_t color = readVarint(data, position);
+                Node* node = graph.getNode(nodeId);
+                if (node == nullptr) {
+                    throw std::out_of_range("Node does not exist");
+                }
+                node->color = color;
+                if (graph.m_changeLog != nullptr) {
+                    graph.m_changeLog->record(Operation::SET_COLOR, nodeId, color);
+                }
+                break;
+            }
+            case Operation::CLEAR:
+                graph.clear();
+                break;
+            default:
+                throw std::runtime_error("Corrupted change log");
+        }
+    }
+}
+
+SubgraphView::SubgraphView(Graph& graph, const std::vector<size_t>& nodeIds) : m_graph(graph) {
+    for (size_t nodeId : nodeIds) {
+        Node* node = graph.getNode(nodeId);
+        if (node == nullptr) {
+            throw std::out_of_range("Node does not exist");
+        }
+        m_nodes.push_back(node);
+    }
+
+    std::sort(m_nodes.begin(), m_nodes.end(), [](const Node* a, const Node* b) {
+        return a->id < b->id;
+    });
+    m_nodes.erase(std::unique(m_nodes.begin(), m_nodes.end()), m_nodes.end());
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        m_index[m_nodes[i]->id] = i;
+    }
+}
+
+SubgraphView::SubgraphView(Graph& graph, const std::function<bool(const Node&)>& predicate) : m_graph(graph) {
+    for (const auto& pair : graph.m_nodes) {
+        if (predicate(*pair.second)) {
+            m_nodes.push_back(pair.second);
+        }
+    }
+
+    std::sort(m_nodes.begin(), m_nodes.end(), [](const Node* a, const Node* b) {
+        return a->id < b->id;
+    });
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        m_index[m_nodes[i]->id] = i;
+    }
 }
 
-std::vector<Node*> Graph::nodes() {
-    std::vector<Node*> nodes;
-    nodes.reserve(m_nodes.size());
+bool SubgraphView::containsNode(size_t nodeId) const {
+    return m_index.find(nodeId) != m_index.end();
+}
 
-    for (const auto& pair : m_nodes) {
-        nodes.push_back(pair.second);
+std::vector<Node*> SubgraphView::nodes() const {
+    return m_nodes;
+}
+
+std::vector<Edge> SubgraphView::edges() const {
+    std::vector<Edge> edges;
+    forEachEdge([&edges](const Edge& edge) {
+        edges.push_back(edge);
+    });
+
+    return edges;
+}
+
+void SubgraphView::forEachEdge(const std::function<void(const Edge&)>& visit) const {
+    // Každou hranu navštívíme z uzlu s menším hustým indexem
+    for (size_t u = 0; u < m_nodes.size(); ++u) {
+        forEachNeighbor(u, [&](size_t v) {
+            if (u < v) {
+                visit(Edge(m_nodes[u]->id, m_nodes[v]->id));
+            }
+        });
     }
+}
 
-    return nodes;
+std::vector<size_t> SubgraphView::neighbors(size_t nodeId) const {
+    std::vector<size_t> neighbors;
+    forEachNeighbor(indexOf(nodeId), [&](size_t v) {
+        neighbors.push_back(m_nodes[v]->id);
+    });
+
+    return neighbors;
 }
 
-std::vector<Edge> Graph::edges() const {
-    return m_edges;
+size_t SubgraphView::nodeCount() const {
+    return m_nodes.size();
 }
 
-Node* Graph::addNode(size_t nodeId) {
-    // Kontrola, zda uzel již existuje
-    if (m_nodes.find(nodeId) != m_nodes.end()) {
-        return nullptr;
+size_t SubgraphView::edgeCount() const {
+    size_t arcs = 0;
+    for (size_t u = 0; u < m_nodes.size(); ++u) {
+        forEachNeighbor(u, [&arcs](size_t) {
+            ++arcs;
+        });
     }
 
-    // Vytvoření nového uzlu
-    Node* newNode = new Node(nodeId);
-    m_nodes[nodeId] = newNode;
+    return arcs / 2;
+}
 
-    // Inicializace prázdného seznamu sousedů pro nový uzel
-    m_adjacency[nodeId] = std::vector<size_t>();
+size_t SubgraphView::nodeDegree(size_t nodeId) const {
+    size_t index = indexOf(nodeId);
+    if (m_materialized) {
+        return m_offsets[index + 1] - m_offsets[index];
+    }
 
-    return newNode;
+    size_t degree = 0;
+    forEachNeighbor(index, [&degree](size_t) {
+        ++degree;
+    });
+
+    return degree;
 }
 
-bool Graph::addEdge(const Edge& edge) {
-    // Ignorování smyček
-    if (edge.a == edge.b) {
-        return false;
+size_t SubgraphView::graphDegree() const {
+    size_t maxDegree = 0;
+    for (const Node* node : m_nodes) {
+        maxDegree = std::max(maxDegree, nodeDegree(node->id));
     }
 
-    // Kontrola, zda hrana již existuje
-    if (containsEdge(edge)) {
-        return false;
+    return maxDegree;
+}
+
+void SubgraphView::coloring() {
+    // Stejné hladové barvení jako Graph::coloring, sousedé mimo podgraf se ignorují
+    std::vector<std::pair<size_t, size_t>> order;
+    order.reserve(m_nodes.size());
+    Graph::ColorSnapshot previous = m_graph.snapshotColors(m_nodes);
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        order.emplace_back(nodeDegree(m_nodes[i]->id), i);
+        m_nodes[i]->color = 0;
     }
 
-    // Přidání uzlů, pokud neexistují
-    if (m_nodes.find(edge.a) == m_nodes.end()) {
-        addNode(edge.a);
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    ColorMask usedColors;
+    for (const auto& entry : order) {
+        usedColors.prepare(entry.first + 1);
+        forEachNeighbor(entry.second, [&](size_t v) {
+            usedColors.mark(m_nodes[v]->color);
+        });
+        m_nodes[entry.second]->color = usedColors.firstFree();
     }
 
-    if (m_nodes.find(edge.b) == m_nodes.end()) {
-        addNode(edge.b);
+    m_graph.logColors(previous);
+}
+
+void SubgraphView::materialize() {
+    m_materialized = false;
+    m_offsets.assign(1, 0);
+    m_targets.clear();
+    for (size_t u = 0; u < m_nodes.size(); ++u) {
+        forEachNeighbor(u, [this](size_t v) {
+            m_targets.push_back(v);
+        });
+        m_offsets.push_back(m_targets.size());
     }
+    m_materialized = true;
+}
 
-    // Přidání hrany
-    m_edges.push_back(edge);
+bool SubgraphView::materialized() const {
+    return m_materialized;
+}
 
-    // Aktualizace seznamů sousedů
-    m_adjacency[edge.a].push_back(edge.b);
-    m_adjacency[edge.b].push_back(edge.a);
+void SubgraphView::forEachNeighbor(size_t index, const std::function<void(size_t)>& visit) const {
+    if (m_materialized) {
+        for (size_t i = m_offsets[index]; i < m_offsets[index + 1]; ++i) {
+            visit(m_targets[i]);
+        }
+        return;
+    }
 
-    return true;
+    for (size_t neighborId : m_graph.m_adjacency.at(m_nodes[index]->id)) {
+        auto it = m_index.find(neighborId);
+        if (it != m_index.end()) {
+            visit(it->second);
+        }
+    }
 }
 
-void Graph::addMultipleEdges(const std::vector<Edge>& edges) {
-    for (const Edge& edge : edges) {
-        addEdge(edge);
+size_t SubgraphView::indexOf(size_t nodeId) const {
+    auto it = m_index.find(nodeId);
+    if (it == m_index.end()) {
+        throw std::out_of_range("Node is not in the subgraph");
     }
+
+    return it->second;
 }
 
-Node* Graph::getNode(size_t nodeId) {
-    auto it = m_nodes.find(nodeId);
-    if (it != m_nodes.end()) {
-        return it->second;
+NamedGraph::NamedGraph() : m_ids(hash_map_ctor()) {
+    if (m_ids == nullptr) {
+        throw std::bad_alloc();
     }
+}
 
-    return nullptr;
+NamedGraph::~NamedGraph() {
+    hash_map_dtor(m_ids);
 }
 
-bool Graph::containsEdge(const Edge& edge) const {
-    // Kontrola existence uzlů
-    auto itA = m_nodes.find(edge.a);
-    auto itB = m_nodes.find(edge.b);
+size_t NamedGraph::intern(const char* name) {
+    // Haš se spočítá jednou pro vyhledání i vložení
+    size_t length = std::strlen(name);
+    size_t hash = hash_map_key_hash(m_ids, name, length);
+    int value;
+    if (hash_map_get_hashed(m_ids, name, length, hash, &value) == OK) {
+        return static_cast<size_t>(value);
+    }
 
-    if (itA == m_nodes.end() || itB == m_nodes.end()) {
-        return false;
+    if (m_names.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("Too many node names");
     }
 
-    // Hledání hrany v seznamu hran
-    for (const Edge& e : m_edges) {
-        if (e == edge) {
-            return true;
-        }
+    size_t nodeId = m_names.size();
+    if (hash_map_put_hashed(m_ids, name, length, hash, static_cast<int>(nodeId)) != OK) {
+        throw std::bad_alloc();
     }
 
-    return false;
+    m_names.push_back(hash_map_stored_key_hashed(m_ids, name, length, hash));
+    m_graph.addNode(nodeId);
+
+    return nodeId;
 }
 
-void Graph::removeNode(size_t nodeId) {
-    auto nodeIt = m_nodes.find(nodeId);
-    if (nodeIt == m_nodes.end()) {
-        throw std::out_of_range("Node does not exist");
+bool NamedGraph::addEdge(const char* a, const char* b) {
+    size_t idA = intern(a);
+    size_t idB = intern(b);
+    return m_graph.addEdge(Edge(idA, idB));
+}
+
+void NamedGraph::addMultipleEdges(const std::vector<std::pair<const char*, const char*>>& edges) {
+    std::vector<Edge> ids;
+    ids.reserve(edges.size());
+    for (const auto& edge : edges) {
+        size_t idA = intern(edge.first);
+        ids.emplace_back(idA, intern(edge.second));
     }
 
-    // Odstranění všech hran spojených s tímto uzlem
-    auto it = m_edges.begin();
-    while (it != m_edges.end()) {
-        if (it->a == nodeId || it->b == nodeId) {
-            // Odstranění ze seznamu sousedů
-            if (it->a == nodeId) {
-                auto& neighbors = m_adjacency[it->b];
-                neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), nodeId), neighbors.end());
-            } else {
-                auto& neighbors = m_adjacency[it->a];
-                neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), nodeId), neighbors.end());
+    m_graph.reserve(m_names.size(), m_graph.edgeCount() + ids.size());
+    m_graph.addMultipleEdges(ids);
+}
+
+bool NamedGraph::contains(const char* name) const {
+    return hash_map_contains(m_ids, name);
+}
+
+size_t NamedGraph::id(const char* name) const {
+    int value;
+    if (hash_map_get(m_ids, name, &value) != OK) {
+        throw std::out_of_range("Node name does not exist");
+    }
+
+    return static_cast<size_t>(value);
+}
+
+const char* NamedGraph::name(size_t nodeId) const {
+    return m_names.at(nodeId);
+}
+
+size_t NamedGraph::nameCount() const {
+    return m_names.size();
+}
+
+Graph& NamedGraph::graph() {
+    return m_graph;
+}
+
+ExternalColoringStats externalColoring(const std::string& edgeFile, const std::string& colorFile,
+                                       const ExternalColoringOptions& options) {
+    ExternalColoringStats stats;
+    std::string line;
+    size_t a;
+    size_t b;
+
+    // 1. průchod: stupně uzlů a rozsah id
+    std::vector<size_t> degree;
+    std::vector<char> present;
+    {
+        std::ifstream input = openEdgeFile(edgeFile);
+        while (readEdgeLine(input, line, a, b)) {
+            size_t maxId = std::max(a, b);
+            if (degree.size() <= maxId) {
+                degree.resize(maxId + 1, 0);
+                present.resize(maxId + 1, 0);
+            }
+            present[a] = present[b] = 1;
+            if (a != b) {
+                ++degree[a];
+                ++degree[b];
+                ++stats.edgeCount;
             }
+        }
+    }
 
-            it = m_edges.erase(it);
-        } else {
-            ++it;
+    // Rozdělení rozsahu id na segmenty, jejichž šipky se vejdou do limitu
+    using Arc = std::pair<uint64_t, uint64_t>;
+    size_t arcBudget = std::max<size_t>(options.memoryBudget / sizeof(Arc), 1);
+    std::vector<size_t> shardBegin{0};
+    size_t shardArcs = 0;
+    for (size_t nodeId = 0; nodeId < degree.size(); ++nodeId) {
+        if (shardArcs > 0 && shardArcs + degree[nodeId] > arcBudget) {
+            shardBegin.push_back(nodeId);
+            shardArcs = 0;
         }
+        shardArcs += degree[nodeId];
+        stats.maxDegree = std::max(stats.maxDegree, degree[nodeId]);
+        stats.nodeCount += present[nodeId];
     }
+    shardBegin.push_back(degree.size());
+    stats.shardCount = shardBegin.size() - 1;
 
-    // Odstranění seznamu sousedů
-    m_adjacency.erase(nodeId);
+    auto shardOf = [&shardBegin](size_t nodeId) {
+        return static_cast<size_t>(std::upper_bound(shardBegin.begin(), shardBegin.end(), nodeId) - shardBegin.begin()) - 1;
+    };
+    // Soubory segmentů leží ve vlastním adresáři, který se smaže i při výjimce
+    ShardDirectory directory(options.tempDirectory);
+    auto shardPath = [&directory](size_t shard) {
+        return (directory.path() / ("graph_shard_" + std::to_string(shard) + ".bin")).string();
+    };
 
-    // Uvolnění paměti uzlu a odstranění z mapy uzlů
-    delete nodeIt->second;
-    m_nodes.erase(nodeIt);
-}
+    // 2. průchod: rozdělení šipek do souborů segmentů, otevřeno je nejvýše 64 souborů najednou
+    const size_t openLimit = 64;
+    for (size_t group = 0; group < stats.shardCount; group += openLimit) {
+        size_t groupEnd = std::min(stats.shardCount, group + openLimit);
+        std::vector<std::ofstream> outputs;
+        for (size_t shard = group; shard < groupEnd; ++shard) {
+            outputs.emplace_back(shardPath(shard), std::ios::binary | std::ios::trunc);
+            if (!outputs.back()) {
+                throw std::runtime_error("Cannot create shard file " + shardPath(shard));
+            }
+        }
 
-void Graph::removeEdge(const Edge& edge) {
-    if (!containsEdge(edge)) {
-        throw std::out_of_range("Edge does not exist");
+        std::ifstream input = openEdgeFile(edgeFile);
+        while (readEdgeLine(input, line, a, b)) {
+            if (a == b) {
+                continue;
+            }
+            for (const Arc& arc : {Arc(a, b), Arc(b, a)}) {
+                size_t shard = shardOf(arc.first);
+                if (shard >= group && shard < groupEnd) {
+                    outputs[shard - group].write(reinterpret_cast<const char*>(&arc), sizeof(Arc));
+                }
+            }
+        }
+
+        for (size_t shard = group; shard < groupEnd; ++shard) {
+            outputs[shard - group].close();
+            if (!outputs[shard - group]) {
+                throw std::runtime_error("Cannot write shard file " + shardPath(shard));
+            }
+        }
     }
 
-    // Odstranění hrany z vektoru hran
-    auto it = m_edges.begin();
-    while (it != m_edges.end()) {
-        if (*it == edge) {
-            // Odstranění ze seznamu sousedů
-            auto& neighborsA = m_adjacency[it->a];
-            neighborsA.erase(std::remove(neighborsA.begin(), neighborsA.end(), it->b), neighborsA.end());
+    // 3. průchod: hladové barvení segmentů, barvy dřívějších segmentů jsou již konečné
+    std::vector<size_t> colors(degree.size(), 0);
+    std::vector<Arc> arcs;
+    ColorMask usedColors;
+    for (size_t shard = 0; shard < stats.shardCount; ++shard) {
+        {
+            std::ifstream input(shardPath(shard), std::ios::binary | std::ios::ate);
+            std::streamoff size = input ? static_cast<std::streamoff>(input.tellg()) : -1;
+            if (size < 0 || size % static_cast<std::streamoff>(sizeof(Arc)) != 0) {
+                throw std::runtime_error("Cannot read shard file " + shardPath(shard));
+            }
+            arcs.resize(static_cast<size_t>(size) / sizeof(Arc));
+            input.seekg(0, std::ios::beg);
+            input.read(reinterpret_cast<char*>(arcs.data()), static_cast<std::streamsize>(size));
+            if (!input) {
+                throw std::runtime_error("Cannot read shard file " + shardPath(shard));
+            }
+        }
+        std::remove(shardPath(shard).c_str());
+        std::sort(arcs.begin(), arcs.end());
 
-            auto& neighborsB = m_adjacency[it->b];
-            neighborsB.erase(std::remove(neighborsB.begin(), neighborsB.end(), it->a), neighborsB.end());
+        auto arc = arcs.begin();
+        for (size_t nodeId = shardBegin[shard]; nodeId < shardBegin[shard + 1]; ++nodeId) {
+            if (!present[nodeId]) {
+                continue;
+            }
+            usedColors.prepare(degree[nodeId] + 1);
+            for (; arc != arcs.end() && arc->first == nodeId; ++arc) {
+                usedColors.mark(colors[arc->second]);
+            }
+            colors[nodeId] = usedColors.firstFree();
+            stats.colorCount = std::max(stats.colorCount, colors[nodeId]);
+        }
+    }
+    arcs = std::vector<Arc>();
 
-            it = m_edges.erase(it);
-            return;
-        } else {
-            ++it;
+    // 4. průchod: kontrola hran, zejména hran mezi segmenty
+    {
+        std::ifstream input = openEdgeFile(edgeFile);
+        while (readEdgeLine(input, line, a, b)) {
+            if (a != b && colors[a] == colors[b]) {
+                throw std::logic_error("Conflicting colors on edge between shards");
+            }
         }
     }
-}
 
-size_t Graph::nodeCount() const {
-    return m_nodes.size();
-}
+    std::ofstream output(colorFile, std::ios::trunc);
+    if (!output) {
+        throw std::runtime_error("Cannot create color file " + colorFile);
+    }
+    for (size_t nodeId = 0; nodeId < colors.size(); ++nodeId) {
+        if (present[nodeId]) {
+            output << nodeId << ' ' << colors[nodeId] << '\n';
+        }
+    }
 
-size_t Graph::edgeCount() const {
-    return m_edges.size();
+    return stats;
 }
 
-size_t Graph::nodeDegree(size_t nodeId) const {
-    auto it = m_adjacency.find(nodeId);
-    if (it == m_adjacency.end()) {
-        throw std::out_of_range("Node does not exist");
+size_t loadEdgeList(Graph& graph, const std::string& path, const GraphLoaderOptions& options) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot open edge file " + path);
     }
 
-    return it->second.size();
-}
+    size_t blockSize = std::max<size_t>(options.blockSize, 1);
+    SpscQueue<std::string> blocks(options.queueCapacity);
+    SpscQueue<std::vector<Edge>> batches(options.queueCapacity);
+    std::atomic<size_t> bytesRead(0);
+    std::atomic<size_t> edgesParsed(0);
 
-size_t Graph::graphDegree() const {
-    if (m_nodes.empty()) {
-        return 0;
+    // Výjimku vlákna předá volajícímu, ostatní fáze se zruší
+    std::exception_ptr readerError;
+    std::exception_ptr parserError;
+    auto runStage = [&](std::exception_ptr& error, auto stage) {
+        try {
+            stage();
+        } catch (...) {
+            error = std::current_exception();
+            blocks.abort();
+            batches.abort();
+        }
+    };
+
+    // Čtení bloků souboru
+    std::thread reader(runStage, std::ref(readerError), [&] {
+        while (true) {
+            std::string block(blockSize, '\0');
+            size_t size = std::fread(&block[0], 1, blockSize, file);
+            if (size == 0) {
+                if (std::ferror(file)) {
+                    throw std::runtime_error("Cannot read edge file " + path);
+                }
+                break;
+            }
+            block.resize(size);
+            bytesRead += size;
+            if (!blocks.push(std::move(block))) {
+                break;
+            }
+        }
+        blocks.close();
+    });
+
+    // Parsování bloků na dávky hran, neúplný poslední řádek bloku se přenáší do dalšího
+    std::thread parser(runStage, std::ref(parserError), [&] {
+        std::string carry;
+        std::string block;
+        size_t a;
+        size_t b;
+        auto parseLines = [&](const char* begin, const char* end, std::vector<Edge>& batch) {
+            while (begin < end) {
+                const char* lineEnd = std::find(begin, end, '\n');
+                const char* contentEnd = lineEnd;
+                if (contentEnd != begin && *(contentEnd - 1) == '\r') {
+                    --contentEnd;
+                }
+                if (parseEdgeLine(begin, contentEnd, a, b)) {
+                    batch.emplace_back(a, b);
+                }
+                begin = lineEnd + 1;
+            }
+        };
+
+        bool running = true;
+        while (running && blocks.pop(block)) {
+            std::vector<Edge> batch;
+            size_t lastNewline = block.rfind('\n');
+            if (lastNewline == std::string::npos) {
+                carry += block;
+                continue;
+            }
+
+            carry.append(block, 0, lastNewline + 1);
+            parseLines(carry.data(), carry.data() + carry.size(), batch);
+            carry.assign(block, lastNewline + 1, std::string::npos);
+
+            edgesParsed += batch.size();
+            running = batches.push(std::move(batch));
+        }
+
+        if (running && !carry.empty()) {
+            std::vector<Edge> batch;
+            parseLines(carry.data(), carry.data() + carry.size(), batch);
+            edgesParsed += batch.size();
+            batches.push(std::move(batch));
+        }
+        batches.close();
+    });
+
+    // Vkládání dávek do grafu probíhá ve volajícím vlákně
+    size_t inserted = 0;
+    try {
+        std::vector<Edge> batch;
+        while (batches.pop(batch)) {
+            size_t before = graph.edgeCount();
+            graph.addMultipleEdges(batch);
+            inserted += graph.edgeCount() - before;
+
+            if (options.progress) {
+                options.progress(GraphLoaderProgress{bytesRead, edgesParsed, inserted});
+            }
+        }
+    } catch (...) {
+        blocks.abort();
+        batches.abort();
+        reader.join();
+        parser.join();
+        std::fclose(file);
+        throw;
     }
 
-    size_t maxDegree = 0;
-    for (const auto& pair : m_adjacency) {
-        maxDegree = std::max(maxDegree, pair.second.size());
+    reader.join();
+    parser.join();
+    std::fclose(file);
+    if (readerError) {
+        std::rethrow_exception(readerError);
+    }
+    if (parserError) {
+        std::rethrow_exception(parserError);
     }
 
-    return maxDegree;
+    return inserted;
 }
 
-void Graph::coloring() {
-    if (m_nodes.empty()) {
+void generateErdosRenyi(Graph& graph, size_t nodeCount, double probability, uint64_t seed) {
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    double expectedEdges = probability * nodeCount * (nodeCount > 0 ? nodeCount - 1 : 0) / 2;
+    graph.reserve(nodeCount, static_cast<size_t>(std::max(0.0, expectedEdges)));
+    for (size_t nodeId = 0; nodeId < nodeCount; ++nodeId) {
+        graph.addNode(nodeId);
+    }
+
+    if (probability <= 0.0) {
         return;
     }
 
-    // Implementace greedy barvení grafu
-    // Nejprve seřadíme uzly podle stupně (sestupně)
-    std::vector<size_t> nodeIds;
-    nodeIds.reserve(m_nodes.size());
+    GeneratedEdges generated(graph);
+    if (probability >= 1.0) {
+        for (size_t v = 1; v < nodeCount; ++v) {
+            for (size_t w = 0; w < v; ++w) {
+                generated.add(v, w);
+            }
+        }
+        generated.flush();
+        return;
+    }
 
-    for (const auto& pair : m_nodes) {
-        nodeIds.push_back(pair.first);
+    // Batagelj-Brandes: délka mezery mezi hranami má geometrické rozdělení,
+    // log1p zachová nenulový logaritmus i pro p pod přesností 1 - p
+    double logComplement = std::log1p(-probability);
+    double pairCount = static_cast<double>(nodeCount) * static_cast<double>(nodeCount - 1) / 2;
+    size_t v = 1;
+    size_t w = 0;
+    bool first = true;
+    while (v < nodeCount) {
+        double skip = std::floor(std::log(1.0 - uniform(engine)) / logComplement);
+
+        // Mezera za všemi zbývajícími dvojicemi generování ukončí dřív, než by převod přetekl
+        double position = static_cast<double>(v) * static_cast<double>(v - 1) / 2 + static_cast<double>(w);
+        if (!(skip < pairCount - position)) {
+            break;
+        }
+
+        w += static_cast<size_t>(skip) + (first ? 0 : 1);
+        first = false;
+        while (w >= v && v < nodeCount) {
+            w -= v;
+            ++v;
+        }
+        if (v < nodeCount) {
+            generated.add(v, w);
+        }
     }
+    generated.flush();
+}
 
-    std::sort(nodeIds.begin(), nodeIds.end(), [this](size_t a, size_t b) {
-        return this->nodeDegree(a) > this->nodeDegree(b);
-    });
+void generateRMat(Graph& graph, size_t scale, size_t edgeCount, uint64_t seed, double a, double b, double c) {
+    if (scale >= size_t(std::numeric_limits<size_t>::digits)) {
+        throw std::invalid_argument("R-MAT scale exceeds node id width");
+    }
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
 
-    // Pro každý uzel najdeme první dostupnou barvu
-    // Barvy číslujeme od 1, 0 znamená neobarveno
-    for (size_t nodeId : nodeIds) {
-        std::set<size_t> neighborColors;
+    graph.reserve(std::min(edgeCount, (size_t(1) << scale) / 2) * 2, edgeCount);
+    for (size_t i = 0; i < edgeCount; ++i) {
+        size_t row = 0;
+        size_t column = 0;
+        for (size_t level = 0; level < scale; ++level) {
+            double r = uniform(engine);
+            row <<= 1;
+            column <<= 1;
+            if (r < a) {
+                // levý horní kvadrant
+            } else if (r < a + b) {
+                column |= 1;
+            } else if (r < a + b + c) {
+                row |= 1;
+            } else {
+                row |= 1;
+                column |= 1;
+            }
+        }
+        graph.addEdge(Edge(row, column));
+    }
+}
 
-        // Sbíráme barvy sousedů
-        for (size_t neighborId : m_adjacency[nodeId]) {
-            size_t neighborColor = m_nodes[neighborId]->color;
-            if (neighborColor != 0) {
-                neighborColors.insert(neighborColor);
+void generateBarabasiAlbert(Graph& graph, size_t nodeCount, size_t edgesPerNode, uint64_t seed) {
+    std::mt19937_64 engine(seed);
+    size_t initial = std::min(nodeCount, edgesPerNode + 1);
+
+    graph.reserve(nodeCount, nodeCount * edgesPerNode);
+
+    // Každý uzel je v seznamu tolikrát, kolik má hran, výběr je tak úměrný stupni
+    std::vector<size_t> endpoints;
+    endpoints.reserve(2 * nodeCount * edgesPerNode);
+
+    GeneratedEdges generated(graph);
+    for (size_t v = 0; v < initial; ++v) {
+        graph.addNode(v);
+        for (size_t w = 0; w < v; ++w) {
+            generated.add(v, w);
+            endpoints.push_back(v);
+            endpoints.push_back(w);
+        }
+    }
+
+    std::vector<size_t> targets;
+    targets.reserve(edgesPerNode);
+    for (size_t v = initial; v < nodeCount; ++v) {
+        targets.clear();
+        while (targets.size() < edgesPerNode) {
+            std::uniform_int_distribution<size_t> pick(0, endpoints.size() - 1);
+            size_t target = endpoints[pick(engine)];
+            if (std::find(targets.begin(), targets.end(), target) == targets.end()) {
+                targets.push_back(target);
             }
         }
 
-        // Najdeme první dostupnou barvu
-        size_t color = 1;
-        while (neighborColors.find(color) != neighborColors.end()) {
-            color++;
+        graph.addNode(v);
+        for (size_t target : targets) {
+            generated.add(v, target);
+            endpoints.push_back(v);
+            endpoints.push_back(target);
         }
+    }
+    generated.flush();
+}
+
+void generateGrid(Graph& graph, size_t rows, size_t columns) {
+    graph.reserve(rows * columns, 2 * rows * columns);
 
-        m_nodes[nodeId]->color = color;
+    GeneratedEdges generated(graph);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < columns; ++c) {
+            size_t nodeId = r * columns + c;
+            graph.addNode(nodeId);
+            if (c > 0) {
+                generated.add(nodeId - 1, nodeId);
+            }
+            if (r > 0) {
+                generated.add(nodeId - columns, nodeId);
+            }
+        }
     }
+    generated.flush();
 }
 
-void Graph::clear() {
-    // Uvolnění paměti všech uzlů
-    for (auto& pair : m_nodes) {
-        delete pair.second;
+void generateCompleteMultipartite(Graph& graph, const std::vector<size_t>& partSizes) {
+    size_t total = 0;
+    size_t edgeCount = 0;
+    for (size_t size : partSizes) {
+        edgeCount += total * size;
+        total += size;
     }
+    graph.reserve(total, edgeCount);
 
-    // Vyčištění datových struktur
-    m_nodes.clear();
-    m_edges.clear();
-    m_adjacency.clear();
+    // Uzel je propojen se všemi uzly předchozích partit
+    GeneratedEdges generated(graph);
+    size_t partBegin = 0;
+    for (size_t size : partSizes) {
+        for (size_t v = partBegin; v < partBegin + size; ++v) {
+            graph.addNode(v);
+            for (size_t w = 0; w < partBegin; ++w) {
+                generated.add(v, w);
+            }
+        }
+        partBegin += size;
+    }
+    generated.flush();
 }
 
 /*** Konec souboru tdd_code.cpp ***/
\ No newline at end of file
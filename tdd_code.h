@@ -24,6 +24,11 @@
 #include <unordered_map>
 #include <algorithm>
 #include <set>
+#include <iterator>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <string>
 
 /**
  * @brief reprezentace uzlu
@@ -83,6 +88,37 @@ public:
     }
 };
 
+/**
+ * @brief Algoritmus barvení hran.
+ */
+enum class EdgeColoringMethod {
+    MISRA_GRIES,  ///< nejvýše graphDegree + 1 barev, paměť úměrná počtu uzlů krát stupni grafu
+    GREEDY        ///< nejvýše 2 * graphDegree - 1 barev, rychlé hladové barvení pro velké grafy
+};
+
+/**
+ * @brief Statistika jedné fáze vykonání po třídách barev.
+ */
+struct ColorPhaseStats {
+    size_t color;                       ///< barva zpracované třídy
+    size_t nodeCount;                   ///< počet uzlů ve třídě
+    std::chrono::nanoseconds duration;  ///< doba zpracování třídy včetně bariéry
+};
+
+/**
+ * @brief Statistika jednoho komunikačního kola distribuovaného barvení.
+ */
+struct DistributedRoundStats {
+    size_t round;          ///< číslo kola od 1
+    size_t messages;       ///< počet zpráv vyměněných koordinátorem s procesy
+    size_t bytesSent;      ///< bajty odeslané koordinátorem
+    size_t bytesReceived;  ///< bajty přijaté koordinátorem
+    size_t conflicts;      ///< počet konfliktů na hranách mezi oddíly nalezených v kole
+};
+
+class GraphChangeLog;
+struct hash_map;
+
 /**
  * @brief Třída reprezentující neorientovaný graf bez smyček.
  *
@@ -128,6 +164,17 @@ public:
      */
     bool addEdge(const Edge& edge);
 
+    /**
+     * @brief Předem vyhradí místo pro zadaný počet uzlů a hran.
+     *
+     * Slouží k hromadnému plnění grafu, kdy je výsledná velikost známa
+     * dopředu a opakovaným realokacím se lze vyhnout.
+     *
+     * @param[in] nodeCount očekávaný počet uzlů
+     * @param[in] edgeCount očekávaný počet hran
+     */
+    void reserve(size_t nodeCount, size_t edgeCount);
+
     /**
      * @brief Naplní graf z vektoru hran. Ignoruje duplicitní hrany a smyčk
      * Pokud uzel definovaný hranou neexistuje, tak bude vytvořen.
@@ -136,6 +183,19 @@ public:
      */
     void addMultipleEdges(const std::vector<Edge>& edges);
 
+    /**
+     * @brief Hromadně připojí hrany, o kterých volající ví, že v grafu nejsou.
+     *
+     * Na rozdíl od addMultipleEdges nekontroluje smyčky ani duplicity, hrany
+     * jen připojí k vektoru hran a seznamům sousedů. Seřazené seznamy sousedů
+     * seřadí jednou po celé dávce a hustotu pro bitovou matici vyhodnotí také
+     * jen jednou. Chybějící uzly vytvoří. Slouží generátorům grafů, které
+     * každou hranu vytvoří nejvýše jednou.
+     *
+     * @param[in] edges hrany bez smyček, navzájem různé a v grafu dosud neexistující
+     */
+    void addDistinctEdges(const std::vector<Edge>& edges);
+
     /**
      * @brief Vrátí ukazatel na uzel s daným id.
      * @param[in] nodeId	Id uzlu.
@@ -200,12 +260,366 @@ public:
      */
     void coloring();
 
+    /**
+     * Pokusí se snížit počet barev stávajícího obarvení.
+     *
+     * Střídá iterované hladové barvení, které prochází uzly po třídách barev
+     * v novém pořadí tříd (počet barev tak nikdy nevzroste), a přebarvení
+     * nejvyšší třídy pomocí výměn Kempeho řetězců. Každé vlákno prohledává
+     * nezávisle se svým generátorem náhodných čísel a nejlepší nalezené
+     * obarvení se sdílí. Pokud uzly nejsou platně obarveny, nejprve se zavolá
+     * coloring(). Do uzlů se zapíše pouze platné obarvení s nejvýše stejným
+     * počtem barev.
+     *
+     * @param[in] maxIterations maximální počet iterací všech vláken dohromady, 0 znamená bez omezení
+     * @param[in] timeBudget časový limit, 0 znamená bez omezení
+     * @param[in] threadCount počet vláken, 0 znamená počet hardwarových vláken
+     * @return počet barev výsledného obarvení
+     * @exception invalid_argument pokud není zadán ani počet iterací, ani časový limit
+     */
+    size_t improveColoring(size_t maxIterations,
+                           std::chrono::milliseconds timeBudget = std::chrono::milliseconds(0),
+                           size_t threadCount = 0);
+
+    /**
+     * Provede obarvení vzdálenosti 2, tedy žádné dva uzly ve vzdálenosti
+     * nejvýše 2 nemají stejnou barvu. Takové obarvení odpovídá kompresi
+     * sloupců řídké Hessovy matice.
+     *
+     * Barva se volí hladově jako první barva nezakázaná sousedy a sousedy
+     * sousedů. Zakázané barvy se značí razítkem uzlu, pole se tedy mezi uzly
+     * nemaže. Při více vláknech se uzly barví spekulativně souběžně, konflikty
+     * se poté detekují a konfliktní uzly s vyšším id se barví znovu.
+     *
+     * @param[in] threadCount počet vláken, 0 znamená počet hardwarových vláken
+     */
+    void distance2Coloring(size_t threadCount = 1);
+
+    /**
+     * Provede částečné obarvení vzdálenosti 2 vybraných uzlů.
+     *
+     * Dva vybrané uzly, které spolu sousedí nebo mají společného souseda,
+     * dostanou různou barvu. Ostatní uzly barvu nemění a omezení neurčují.
+     * Pro bipartitní graf řádků a sloupců řídké Jacobiho matice, kde jsou
+     * vybrány sloupce, odpovídají třídy barev sloupcům vyhodnotitelným
+     * jedním voláním funkce.
+     *
+     * @param[in] nodeIds id barvených uzlů
+     * @param[in] threadCount počet vláken, 0 znamená počet hardwarových vláken
+     * @exception out_of_range pokud některý z uzlů v grafu neexistuje
+     */
+    void partialDistance2Coloring(const std::vector<size_t>& nodeIds, size_t threadCount = 1);
+
+    /**
+     * Obarví graf pomocí několika pracovních procesů propojených soketovými páry.
+     *
+     * Uzly jsou podle id rozděleny na souvislé oddíly, každý oddíl dostane
+     * jeden proces. Proces obdrží po soketu pouze seznamy sousedů svých uzlů
+     * a barví je hladově podle barev svých uzlů a naposledy známých barev
+     * sousedů z cizích oddílů. Koordinátor po každém kole porovná barvy na
+     * hranách mezi oddíly, z konfliktní dvojice nechá přebarvit uzel s vyšším
+     * id a rozešle změněné barvy procesům, které je potřebují. Kola se
+     * opakují, dokud nějaký konflikt zbývá. Každý uzel dostane nejvýše barvu
+     * o 1 vyšší než jeho stupeň.
+     *
+     * @warning Procesy se spouští voláním fork, funkce je proto dostupná jen
+     *          na systémech POSIX a nesmí se volat z vícevláknového procesu,
+     *          protože potomek alokuje paměť a zámek alokátoru mohlo v okamžiku
+     *          fork držet jiné vlákno. Vlákna vytvořená ostatními metodami
+     *          grafu jsou před jejich návratem vždy ukončena.
+     *
+     * @param[in] workerCount počet pracovních procesů
+     * @return statistika komunikace v jednotlivých kolech
+     * @exception invalid_argument pokud je počet procesů nulový
+     * @exception runtime_error pokud selže vytvoření procesu nebo komunikace,
+     *            nebo systém pracovní procesy nepodporuje
+     */
+    std::vector<DistributedRoundStats> distributedColoring(size_t workerCount);
+
+    /**
+     * Obarví hrany grafu tak, že hrany se společným uzlem mají různou barvu.
+     *
+     * Barvy hran jsou uloženy souběžně s vektorem hran a lze je zjistit
+     * metodou edgeColor. Každá třída barev tvoří párování, hrany jedné třídy
+     * tak mohou být zpracovány současně.
+     *
+     * @param[in] method použitý algoritmus
+     * @return párování pro jednotlivé barvy, prvek i obsahuje hrany barvy i + 1
+     */
+    std::vector<std::vector<Edge>> edgeColoring(EdgeColoringMethod method = EdgeColoringMethod::MISRA_GRIES);
+
+    /**
+     * @brief Vrátí barvu hrany přiřazenou metodou edgeColoring.
+     *
+     * Barvy jsou uloženy v hašovací mapě podle hrany, dotaz na obarvenou
+     * hranu trvá O(1), u neobarvené se ověří existence hrany.
+     *
+     * @param[in] edge hrana
+     * @return barva hrany, 0 znamená neobarveno
+     * @exception out_of_range pokud hrana v grafu neexistuje
+     */
+    size_t edgeColor(const Edge& edge) const;
+
+    /**
+     * Zavolá @p task pro každý uzel grafu tak, že souběžně běží pouze uzly stejné barvy.
+     *
+     * Třídy barev se zpracovávají postupně vzestupně podle barvy s bariérou
+     * mezi nimi. Uzly třídy jsou rozděleny do dávek po @p grainSize, které si
+     * vlákna rozeberou z vlastních front a při nečinnosti kradou dávky z front
+     * ostatních vláken. Pokud některý uzel není obarven, zavolá se nejprve
+     * coloring(). Bezkonfliktnost zaručuje pouze platné obarvení.
+     *
+     * @param[in] task funkce volaná pro každý uzel
+     * @param[in] threadCount počet vláken, 0 znamená počet hardwarových vláken
+     * @param[in] grainSize počet uzlů v jedné dávce
+     * @return statistika jednotlivých fází v pořadí zpracování
+     */
+    std::vector<ColorPhaseStats> executeByColor(const std::function<void(Node*)>& task,
+                                                size_t threadCount = 0, size_t grainSize = 64);
+
     /**
      * Smazání všech uzlů a hran v grafu.
      */
     void clear();
 
+    /**
+     * @brief Připojí k grafu záznam změn.
+     *
+     * Graf do záznamu zapisuje přidání a odebrání uzlů a hran, smazání grafu
+     * a barvy uzlů po každém barvení. Přímé přiřazení do Node::color se
+     * nezaznamenává, lze jej zapsat voláním GraphChangeLog::record. Záznam
+     * musí existovat, dokud je připojen.
+     *
+     * @param[in] log záznam změn, nullptr záznam odpojí
+     */
+    void attachChangeLog(GraphChangeLog* log);
+
+    /**
+     * @brief Zapne nebo vypne udržování seznamů sousedů seřazených podle id.
+     *
+     * Se seřazenými seznamy ověří containsEdge existenci hrany binárním
+     * vyhledáváním v čase O(log d) a průniky sousedů se počítají slitím.
+     * Při zapnutí jsou stávající seznamy jednorázově seřazeny.
+     *
+     * @param[in] sorted true pokud mají být seznamy sousedů seřazené
+     */
+    void setSortedAdjacency(bool sorted);
+
+    /**
+     * @return true pokud jsou seznamy sousedů udržovány seřazené
+     */
+    bool sortedAdjacency() const;
+
+    /**
+     * @brief Zapne nebo vypne líné odebírání hran.
+     *
+     * V líném režimu removeEdge a removeNode hrany z vektoru hran fyzicky
+     * neodebírají, pouze je označí jako odebrané. Pozici hrany ve vektoru
+     * najdou v hashovací tabulce v čase O(1). Vektor hran se zhutní, jakmile
+     * podíl odebraných hran překročí @p compactionRatio. Seznamy sousedů se
+     * aktualizují ihned. Při vypnutí se vektor hran zhutní.
+     *
+     * @param[in] enabled true pro zapnutí líného režimu
+     * @param[in] compactionRatio podíl odebraných hran, při kterém se vektor hran zhutní
+     * @exception invalid_argument pokud podíl neleží v intervalu (0, 1]
+     */
+    void setLazyEdgeDeletion(bool enabled, double compactionRatio = 0.25);
+
+    /**
+     * @return true pokud je zapnuto líné odebírání hran
+     */
+    bool lazyEdgeDeletion() const;
+
+    /**
+     * @brief Fyzicky odstraní z vektoru hran hrany označené jako odebrané.
+     */
+    void compactEdges();
+
+    /**
+     * @brief Nastaví, kdy graf udržuje vedle seznamů sousedů bitovou matici sousednosti.
+     *
+     * Matice se sestaví automaticky, jakmile má graf alespoň 64 a nejvýše
+     * @p maxNodes uzlů a hustota hran dosáhne @p densityThreshold. Zruší se,
+     * když hustota klesne pod polovinu prahu nebo počet uzlů překročí limit.
+     * S maticí ověří containsEdge hranu v čase O(1), commonNeighbors
+     * a triangleCount počítají průniky po 64bitových slovech a coloring
+     * hledá barvu maskováním řádku uzlu bitovými množinami barevných tříd.
+     * Seznamy sousedů zůstávají kanonickou reprezentací. Výchozí nastavení
+     * je práh 0.3 a nejvýše 4096 uzlů, matice tak zabere přibližně nejvýše 2 MiB.
+     *
+     * @param[in] densityThreshold prahová hustota z intervalu (0, 1]
+     * @param[in] maxNodes nejvyšší počet uzlů, pro který se matice udržuje, 0 matici vypne
+     * @exception invalid_argument pokud práh neleží v intervalu (0, 1]
+     */
+    void setDenseMatrixPolicy(double densityThreshold, size_t maxNodes);
+
+    /**
+     * @return true pokud graf aktuálně udržuje bitovou matici sousednosti
+     */
+    bool denseMatrixActive() const;
+
+    /**
+     * @brief Vrátí společné sousedy dvou uzlů.
+     * @param[in] a id prvního uzlu
+     * @param[in] b id druhého uzlu
+     * @return vzestupně seřazený vektor id uzlů sousedících s oběma uzly
+     * @exception out_of_range pokud některý z uzlů v grafu neexistuje
+     */
+    std::vector<size_t> commonNeighbors(size_t a, size_t b) const;
+
+    /**
+     * Spočítá trojúhelníky v grafu. Každá hrana je orientována od uzlu s nižším
+     * stupněm k uzlu s vyšším stupněm a trojúhelníky se hledají slitím
+     * seřazených výstupních seznamů, takže každý je započten právě jednou.
+     *
+     * @return počet trojúhelníků v grafu
+     */
+    size_t triangleCount() const;
+
 protected:
+    friend class SubgraphView;
+    friend class GraphChangeLog;
+
+    /// Barvy uzlů uložené před barvením, dvojice uzlu a jeho původní barvy
+    using ColorSnapshot = std::vector<std::pair<Node*, size_t>>;
+
+    /**
+     * @brief Uloží barvy všech uzlů před barvením.
+     * @return uložené barvy, prázdné pokud není připojen záznam změn
+     */
+    ColorSnapshot snapshotColors() const;
+
+    /**
+     * @brief Uloží barvy zadaných uzlů před barvením.
+     * @param[in] nodes uzly, jejichž barvy se uloží
+     * @return uložené barvy, prázdné pokud není připojen záznam změn
+     */
+    ColorSnapshot snapshotColors(const std::vector<Node*>& nodes) const;
+
+    /**
+     * @brief Zapíše do připojeného záznamu změn barvy uzlů, které se od uložení změnily.
+     * @param[in] snapshot barvy uložené před barvením
+     */
+    void logColors(const ColorSnapshot& snapshot);
+
+    /**
+     * @brief Kompaktní kopie sousednosti ve formátu CSR s hustě číslovanými uzly.
+     */
+    struct CompactAdjacency {
+        std::vector<Node*> nodes;     ///< uzly seřazené podle id, index v poli je hustý index uzlu
+        std::vector<size_t> offsets;  ///< začátek seznamu sousedů uzlu i, poslední prvek je počet šipek
+        std::vector<size_t> targets;  ///< husté indexy sousedů
+    };
+
+    /**
+     * @brief Vytvoří kompaktní kopii sousednosti pro algoritmy nad celým grafem.
+     * @return kompaktní sousednost
+     */
+    CompactAdjacency compactAdjacency() const;
+
+    /**
+     * @brief Hash hrany nezávislý na pořadí uzlů, shodný pro hrany rovné podle Edge::operator==.
+     */
+    struct EdgeHash {
+        size_t operator()(const Edge& edge) const {
+            std::hash<size_t> hash;
+            return hash(std::min(edge.a, edge.b)) * 31 + hash(std::max(edge.a, edge.b));
+        }
+    };
+
+    /**
+     * @brief Označí hranu na dané pozici jako odebranou.
+     * @param[in] index pozice hrany ve vektoru hran
+     */
+    void markEdgeDead(size_t index);
+
+    /**
+     * @brief Bitová matice sousednosti pro husté grafy.
+     *
+     * Uzly mají husté indexy v pořadí přidání, řádek uzlu i je bitová
+     * množina indexů jeho sousedů. Index odebraného uzlu zůstane neobsazený
+     * s prázdným řádkem i sloupcem. Matice má rezervu pro další uzly, po
+     * jejím vyčerpání se sestaví znovu.
+     */
+    struct DenseMatrix {
+        std::unordered_map<size_t, size_t> index;  ///< id uzlu na hustý index
+        std::vector<size_t> ids;                   ///< hustý index na id uzlu
+        size_t stride = 0;                         ///< počet 64bitových slov řádku, 0 znamená neaktivní matici
+        std::vector<uint64_t> bits;                ///< řádky matice za sebou
+
+        bool active() const {
+            return stride != 0;
+        }
+
+        const uint64_t* row(size_t i) const {
+            return bits.data() + i * stride;
+        }
+
+        bool test(size_t i, size_t j) const {
+            return (bits[i * stride + (j >> 6)] >> (j & 63)) & 1;
+        }
+
+        void set(size_t i, size_t j) {
+            bits[i * stride + (j >> 6)] |= uint64_t(1) << (j & 63);
+            bits[j * stride + (i >> 6)] |= uint64_t(1) << (i & 63);
+        }
+
+        void reset(size_t i, size_t j) {
+            bits[i * stride + (j >> 6)] &= ~(uint64_t(1) << (j & 63));
+            bits[j * stride + (i >> 6)] &= ~(uint64_t(1) << (i & 63));
+        }
+    };
+
+    /**
+     * @brief Sestaví bitovou matici ze seznamů sousedů.
+     */
+    void buildDenseMatrix();
+
+    /**
+     * @brief Podle hustoty a počtu uzlů bitovou matici sestaví nebo zruší.
+     */
+    void updateDenseMatrix();
+
+    /**
+     * @brief Zruší bitovou matici, pokud hustota klesla pod polovinu prahu.
+     *
+     * Odebrání hrany hustotu jen snižuje, matici proto nelze sestavit.
+     */
+    void shrinkDenseMatrix();
+
+    /**
+     * @return podíl hran grafu z počtu všech možných hran
+     */
+    double edgeDensity() const;
+
+    /**
+     * @brief Obarví graf hladovým algoritmem nad bitovou maticí.
+     * @param[in] order uzly v pořadí barvení
+     */
+    void denseColoring(const std::vector<std::pair<size_t, Node*>>& order);
+
+    /**
+     * @brief Zjistí, zda seznam sousedů obsahuje daný uzel.
+     * @param[in] neighbors seznam sousedů
+     * @param[in] nodeId id hledaného uzlu
+     * @return true pokud seznam uzel obsahuje
+     */
+    bool hasNeighbor(const std::vector<size_t>& neighbors, size_t nodeId) const;
+
+    /**
+     * @brief Vloží uzel do seznamu sousedů se zachováním případného seřazení.
+     * @param[in, out] neighbors seznam sousedů
+     * @param[in] nodeId id vkládaného uzlu
+     */
+    void insertNeighbor(std::vector<size_t>& neighbors, size_t nodeId);
+
+    /**
+     * @brief Odstraní uzel ze seznamu sousedů se zachováním pořadí.
+     * @param[in, out] neighbors seznam sousedů
+     * @param[in] nodeId id odstraňovaného uzlu
+     */
+    void eraseNeighbor(std::vector<size_t>& neighbors, size_t nodeId);
+
     // Mapa pro ukládání uzlů, kde klíč je ID uzlu a hodnota je ukazatel na uzel
     std::unordered_map<size_t, Node*> m_nodes;
 
@@ -214,8 +628,492 @@ protected:
 
     // Mapa pro ukládání sousednosti uzlů, kde klíč je ID uzlu a hodnota je vektor ID sousedních uzlů
     std::unordered_map<size_t, std::vector<size_t>> m_adjacency;
+
+    // Barvy hran přiřazené metodou edgeColoring, hrana bez záznamu je neobarvená
+    std::unordered_map<Edge, size_t, EdgeHash> m_edgeColors;
+
+    // Příznaky líně odebraných hran, prvek i patří hraně m_edges[i], udržují se jen v líném režimu
+    std::vector<bool> m_edgeDead;
+
+    // Počet líně odebraných hran ve vektoru hran
+    size_t m_deadEdges = 0;
+
+    // Pozice živých hran ve vektoru hran, udržuje se jen v líném režimu
+    std::unordered_map<Edge, size_t, EdgeHash> m_edgeIndex;
+
+    // Příznak líného odebírání hran a podíl odebraných hran vyvolávající zhutnění
+    bool m_lazyEdgeDeletion = false;
+    double m_compactionRatio = 0.25;
+
+    // Příznak, zda jsou seznamy sousedů udržovány vzestupně seřazené
+    bool m_sortedAdjacency = false;
+
+    // Bitová matice sousednosti, udržuje se jen pro husté grafy
+    DenseMatrix m_dense;
+
+    // Prahová hustota a nejvyšší počet uzlů pro udržování bitové matice
+    double m_denseThreshold = 0.3;
+    size_t m_denseMaxNodes = 4096;
+
+    // Připojený záznam změn, nullptr pokud se změny nezaznamenávají
+    GraphChangeLog* m_changeLog = nullptr;
+};
+
+/**
+ * @brief Záznam změn grafu pro replikaci.
+ *
+ * Záznam je posloupnost binárních záznamů operací, které lze přehrát na
+ * replice grafu. Každý záznam tvoří bajt operace následovaný jejími
+ * argumenty kódovanými jako varint (7 bitů na bajt), takže malá id zabírají
+ * jeden bajt. Pozice v záznamu jsou logické bajtové offsety, které se
+ * zhutněním nemění. Replika si pamatuje offset, do kterého záznam přehrála,
+ * a při další synchronizaci přenese jen novější záznamy. Replika, jejíž
+ * offset byl zhutněním odstraněn, načte snímek a pokračuje od offsetu,
+ * ke kterému snímek vznikl.
+ */
+class GraphChangeLog {
+public:
+    /**
+     * @brief Typ zaznamenané operace.
+     */
+    enum class Operation : uint8_t {
+        ADD_NODE = 1,  ///< argument id uzlu
+        ADD_EDGE,      ///< argumenty id obou uzlů hrany
+        REMOVE_NODE,   ///< argument id uzlu
+        REMOVE_EDGE,   ///< argumenty id obou uzlů hrany
+        SET_COLOR,     ///< argumenty id uzlu a jeho barva
+        CLEAR          ///< bez argumentů
+    };
+
+    /**
+     * @brief Připojí na konec záznamu operaci.
+     * @param[in] operation typ operace
+     * @param[in] first první argument, pokud jej operace má
+     * @param[in] second druhý argument, pokud jej operace má
+     */
+    void record(Operation operation, size_t first = 0, size_t second = 0);
+
+    /**
+     * @return offset konce záznamu, tedy offset příští operace
+     */
+    size_t offset() const;
+
+    /**
+     * @return nejmenší offset, od kterého je záznam k dispozici
+     */
+    size_t baseOffset() const;
+
+    /**
+     * @brief Vrátí zakódované operace od daného offsetu do konce záznamu.
+     * @param[in] fromOffset offset začátku operace vrácený metodou offset
+     * @return zakódované operace k přenosu na repliku
+     * @exception out_of_range pokud offset neleží mezi baseOffset a offset
+     */
+    std::vector<uint8_t> read(size_t fromOffset) const;
+
+    /**
+     * @brief Přehraje operace od daného offsetu do konce záznamu na replice.
+     * @param[in, out] graph replika grafu
+     * @param[in] fromOffset offset začátku operace vrácený metodou offset
+     * @return offset konce záznamu, od kterého bude replika pokračovat
+     * @exception out_of_range pokud offset neleží mezi baseOffset a offset
+     */
+    size_t replay(Graph& graph, size_t fromOffset) const;
+
+    /**
+     * @brief Zahodí operace před daným offsetem, pokrývá je snímek grafu.
+     * @param[in] offset offset vrácený metodou offset v okamžiku pořízení snímku
+     * @exception out_of_range pokud offset neleží mezi baseOffset a offset
+     */
+    void compact(size_t offset);
+
+    /**
+     * @brief Zakóduje celý stav grafu jako posloupnost operací.
+     *
+     * Snímek začíná operací CLEAR, po jeho aplikaci je replika shodná
+     * s grafem v okamžiku pořízení snímku.
+     *
+     * @param[in] graph graf
+     * @return zakódovaný snímek
+     */
+    static std::vector<uint8_t> snapshot(Graph& graph);
+
+    /**
+     * @brief Aplikuje zakódované operace na graf.
+     * @param[in, out] graph replika grafu
+     * @param[in] data operace získané metodou read nebo snapshot
+     * @exception runtime_error pokud data nejsou platným záznamem
+     * @exception out_of_range pokud operace odkazuje na neexistující uzel nebo hranu
+     */
+    static void apply(Graph& graph, const std::vector<uint8_t>& data);
+
+private:
+    // Offset prvního bajtu v m_data
+    size_t m_baseOffset = 0;
+
+    // Zakódované operace od m_baseOffset
+    std::vector<uint8_t> m_data;
+};
+
+/**
+ * @brief Indukovaný podgraf nad existujícím grafem bez kopírování hran.
+ *
+ * Podgraf je určen množinou uzlů, která se vyhodnotí při konstrukci. Hrany
+ * se z grafu filtrují až při přístupu. Při opakovaném přístupu lze podgraf
+ * metodou materialize převést do kompaktní reprezentace CSR. Pohled
+ * neudržuje změny grafu: po odstranění uzlu z grafu je neplatný a po
+ * změně hran je nutné znovu zavolat materialize.
+ */
+class SubgraphView {
+public:
+    /**
+     * @brief Vytvoří podgraf indukovaný zadanými uzly.
+     * @param[in] graph graf, nad kterým podgraf vzniká
+     * @param[in] nodeIds id uzlů podgrafu
+     * @exception out_of_range pokud některý z uzlů v grafu neexistuje
+     */
+    SubgraphView(Graph& graph, const std::vector<size_t>& nodeIds);
+
+    /**
+     * @brief Vytvoří podgraf indukovaný uzly splňujícími predikát.
+     * @param[in] graph graf, nad kterým podgraf vzniká
+     * @param[in] predicate predikát určující uzly podgrafu
+     */
+    SubgraphView(Graph& graph, const std::function<bool(const Node&)>& predicate);
+
+    /**
+     * @param[in] nodeId id uzlu
+     * @return true pokud uzel patří do podgrafu
+     */
+    bool containsNode(size_t nodeId) const;
+
+    /**
+     * @return ukazatele na uzly podgrafu seřazené podle id
+     */
+    std::vector<Node*> nodes() const;
+
+    /**
+     * @return vektor hran podgrafu
+     */
+    std::vector<Edge> edges() const;
+
+    /**
+     * @brief Zavolá @p visit pro každou hranu podgrafu bez vytváření vektoru hran.
+     * @param[in] visit funkce volaná pro každou hranu
+     */
+    void forEachEdge(const std::function<void(const Edge&)>& visit) const;
+
+    /**
+     * @param[in] nodeId id uzlu
+     * @return id sousedů uzlu v rámci podgrafu
+     * @exception out_of_range pokud uzel do podgrafu nepatří
+     */
+    std::vector<size_t> neighbors(size_t nodeId) const;
+
+    /**
+     * @return počet uzlů podgrafu
+     */
+    size_t nodeCount() const;
+
+    /**
+     * @return počet hran podgrafu
+     */
+    size_t edgeCount() const;
+
+    /**
+     * @param[in] nodeId id uzlu
+     * @return stupeň uzlu v rámci podgrafu
+     * @exception out_of_range pokud uzel do podgrafu nepatří
+     */
+    size_t nodeDegree(size_t nodeId) const;
+
+    /**
+     * @return maximální stupeň uzlu v rámci podgrafu
+     */
+    size_t graphDegree() const;
+
+    /**
+     * Obarví uzly podgrafu nejvýše graphDegree() + 1 barvami. Hrany vedoucí
+     * mimo podgraf se neuvažují a barvy ostatních uzlů grafu se nemění.
+     */
+    void coloring();
+
+    /**
+     * Převede podgraf do kompaktní reprezentace CSR. Následné dotazy již
+     * nefiltrují sousedy grafu. Opakované volání reprezentaci obnoví.
+     */
+    void materialize();
+
+    /**
+     * @return true pokud je podgraf převeden do reprezentace CSR
+     */
+    bool materialized() const;
+
+private:
+    /**
+     * @brief Zavolá @p visit pro husté indexy sousedů uzlu v podgrafu.
+     * @param[in] index hustý index uzlu
+     * @param[in] visit funkce volaná pro každý hustý index souseda
+     */
+    void forEachNeighbor(size_t index, const std::function<void(size_t)>& visit) const;
+
+    /**
+     * @param[in] nodeId id uzlu
+     * @return hustý index uzlu
+     * @exception out_of_range pokud uzel do podgrafu nepatří
+     */
+    size_t indexOf(size_t nodeId) const;
+
+    Graph& m_graph;
+    // Uzly podgrafu seřazené podle id, pozice v poli je hustý index uzlu
+    std::vector<Node*> m_nodes;
+    // Převod id uzlu na hustý index
+    std::unordered_map<size_t, size_t> m_index;
+    // Reprezentace CSR po zavolání materialize
+    bool m_materialized = false;
+    std::vector<size_t> m_offsets;
+    std::vector<size_t> m_targets;
+};
+
+/**
+ * @brief Graf s uzly pojmenovanými řetězci.
+ *
+ * Jména uzlů se internují v hašovací tabulce hash_map_t na hustá id
+ * 0, 1, 2, ... v pořadí prvního výskytu, pod kterými se uzly vkládají do
+ * vlastněného grafu. Jméno se hašuje jednou a kopíruje jen při prvním
+ * výskytu do tabulky, zpětný převod id na jméno vrací ukazatel na tuto
+ * jedinou kopii získaný přes hash_map_stored_key_hashed.
+ */
+class NamedGraph {
+public:
+    /**
+     * @brief Vytvoří prázdný pojmenovaný graf.
+     * @exception bad_alloc pokud se nepodaří alokovat hašovací tabulku
+     */
+    NamedGraph();
+
+    ~NamedGraph();
+
+    NamedGraph(const NamedGraph&) = delete;
+    NamedGraph& operator=(const NamedGraph&) = delete;
+
+    /**
+     * @brief Vrátí id uzlu se zadaným jménem, neexistující uzel vytvoří.
+     * @param[in] name jméno uzlu
+     * @return id uzlu
+     * @exception bad_alloc pokud se nepodaří vložit jméno do tabulky
+     */
+    size_t intern(const char* name);
+
+    /**
+     * @brief Přidá hranu mezi pojmenované uzly, chybějící uzly vytvoří.
+     * @param[in] a jméno prvního uzlu
+     * @param[in] b jméno druhého uzlu
+     * @return true pokud byla hrana přidána
+     */
+    bool addEdge(const char* a, const char* b);
+
+    /**
+     * @brief Přidá hrany mezi pojmenované uzly.
+     *
+     * Nejprve internuje všechna jména a hrany pak vloží do grafu najednou.
+     *
+     * @param[in] edges dvojice jmen uzlů hran
+     */
+    void addMultipleEdges(const std::vector<std::pair<const char*, const char*>>& edges);
+
+    /**
+     * @param[in] name jméno uzlu
+     * @return true pokud uzel se zadaným jménem existuje
+     */
+    bool contains(const char* name) const;
+
+    /**
+     * @brief Převede jméno uzlu na id.
+     * @param[in] name jméno uzlu
+     * @return id uzlu
+     * @exception out_of_range pokud uzel se zadaným jménem neexistuje
+     */
+    size_t id(const char* name) const;
+
+    /**
+     * @brief Převede id uzlu na jméno.
+     * @param[in] nodeId id uzlu
+     * @return jméno uzlu platné po dobu existence pojmenovaného grafu
+     * @exception out_of_range pokud uzel se zadaným id neexistuje
+     */
+    const char* name(size_t nodeId) const;
+
+    /**
+     * @return počet internovaných jmen
+     */
+    size_t nameCount() const;
+
+    /**
+     * @return graf s hustě číslovanými uzly
+     */
+    Graph& graph();
+
+private:
+    // Tabulka jmen, hodnotou je id uzlu
+    hash_map* m_ids;
+
+    // Jména uzlů podle id, ukazují na klíče uložené v tabulce
+    std::vector<const char*> m_names;
+
+    Graph m_graph;
 };
 
+/**
+ * @brief Nastavení barvení grafu uloženého mimo operační paměť.
+ */
+struct ExternalColoringOptions {
+    size_t memoryBudget = size_t(64) << 20;  ///< maximální velikost hran jednoho segmentu v paměti v bajtech
+    std::string tempDirectory = ".";         ///< adresář, ve kterém se vytvoří jedinečný dočasný adresář segmentů
+};
+
+/**
+ * @brief Výsledek barvení grafu uloženého mimo operační paměť.
+ */
+struct ExternalColoringStats {
+    size_t nodeCount = 0;   ///< počet uzlů, které se v seznamu hran vyskytly
+    size_t edgeCount = 0;   ///< počet načtených hran bez smyček
+    size_t shardCount = 0;  ///< počet segmentů, po kterých se barvilo
+    size_t maxDegree = 0;   ///< maximální stupeň uzlu včetně duplicitních hran
+    size_t colorCount = 0;  ///< počet použitých barev
+};
+
+/**
+ * @brief Obarví graf zadaný seznamem hran v souboru po segmentech uzlů.
+ *
+ * Vstupní soubor obsahuje na každém řádku dvojici id uzlů oddělených
+ * mezerou, prázdné řádky a řádky začínající znakem # se přeskakují.
+ * Rozsah id uzlů se rozdělí na segmenty tak, aby hrany jednoho segmentu
+ * nepřesáhly @c memoryBudget. Hrany se rozdělí do dočasných souborů
+ * segmentů a segmenty se barví postupně hladově první volnou barvou, takže
+ * každý uzel dostane barvu nejvýše o 1 vyšší než jeho stupeň. V paměti se
+ * kromě jednoho segmentu drží pouze pole barev a stupňů indexované id uzlu,
+ * id by proto měla být hustá. Závěrečný průchod vstupem ověří hrany mezi
+ * segmenty. Výstupní soubor obsahuje vzestupně podle id řádky "uzel barva".
+ * Dočasné soubory leží v jedinečném podadresáři @c tempDirectory, který se
+ * po skončení smaže i v případě výjimky.
+ *
+ * @param[in] edgeFile cesta k seznamu hran
+ * @param[in] colorFile cesta k výstupnímu souboru s barvami
+ * @param[in] options nastavení paměťového limitu a dočasného adresáře
+ * @return statistika barvení
+ * @exception runtime_error pokud nelze číst nebo zapisovat soubory
+ * @exception out_of_range pokud se id uzlu nevejde do size_t
+ */
+ExternalColoringStats externalColoring(const std::string& edgeFile, const std::string& colorFile,
+                                       const ExternalColoringOptions& options = ExternalColoringOptions());
+
+/**
+ * @brief Průběh načítání seznamu hran.
+ */
+struct GraphLoaderProgress {
+    size_t bytesRead;      ///< počet bajtů přečtených ze souboru
+    size_t edgesParsed;    ///< počet rozparsovaných hran
+    size_t edgesInserted;  ///< počet hran nově přidaných do grafu
+};
+
+/**
+ * @brief Nastavení zřetězeného načítání seznamu hran.
+ */
+struct GraphLoaderOptions {
+    size_t blockSize = size_t(1) << 20;  ///< velikost bloku čteného ze souboru v bajtech
+    size_t queueCapacity = 8;            ///< kapacita front mezi fázemi, plná fronta pozdrží předchozí fázi
+    std::function<void(const GraphLoaderProgress&)> progress;  ///< volá se po vložení každé dávky hran
+};
+
+/**
+ * @brief Načte do grafu seznam hran ze souboru zřetězeně ve třech fázích.
+ *
+ * Čtení bloků souboru, parsování bloků na dávky hran a vkládání dávek do
+ * grafu běží souběžně a jsou propojeny omezenými frontami bez zámků.
+ * Formát souboru je stejný jako u externalColoring. Vkládání probíhá ve
+ * volajícím vlákně, stejně jako v addMultipleEdges jsou smyčky a duplicitní
+ * hrany ignorovány.
+ *
+ * @param[in, out] graph graf, do kterého se hrany přidají
+ * @param[in] path cesta k seznamu hran
+ * @param[in] options nastavení velikosti bloků, front a hlášení průběhu
+ * @return počet hran nově přidaných do grafu
+ * @exception runtime_error pokud soubor nelze otevřít nebo číst
+ * @exception out_of_range pokud se id uzlu nevejde do size_t
+ */
+size_t loadEdgeList(Graph& graph, const std::string& path, const GraphLoaderOptions& options = GraphLoaderOptions());
+
+/**
+ * @brief Vygeneruje náhodný graf G(n, p) podle Erdőse a Rényiho.
+ *
+ * Do grafu přidá uzly 0 až n - 1 a každou z možných hran s pravděpodobností
+ * @p probability. Hrany se generují přeskakováním s geometrickým rozdělením,
+ * takže čas odpovídá počtu vytvořených hran, nikoliv n^2.
+ *
+ * @param[in, out] graph graf, do kterého se hrany přidají
+ * @param[in] nodeCount počet uzlů
+ * @param[in] probability pravděpodobnost existence hrany
+ * @param[in] seed semínko generátoru náhodných čísel
+ */
+void generateErdosRenyi(Graph& graph, size_t nodeCount, double probability, uint64_t seed);
+
+/**
+ * @brief Vygeneruje graf R-MAT (rekurzivní Kroneckerův model).
+ *
+ * Každá hrana vzniká rekurzivním výběrem kvadrantu matice sousednosti
+ * s pravděpodobnostmi @p a, @p b, @p c a 1 - a - b - c. Smyčky a duplicitní
+ * hrany jsou stejně jako v addEdge ignorovány, výsledný počet hran tak může
+ * být menší než @p edgeCount.
+ *
+ * @param[in, out] graph graf, do kterého se hrany přidají
+ * @param[in] scale logaritmus počtu uzlů, uzly mají id 0 až 2^scale - 1
+ * @param[in] edgeCount počet generovaných hran
+ * @param[in] seed semínko generátoru náhodných čísel
+ * @param[in] a pravděpodobnost levého horního kvadrantu
+ * @param[in] b pravděpodobnost pravého horního kvadrantu
+ * @param[in] c pravděpodobnost levého dolního kvadrantu
+ * @exception invalid_argument pokud je @p scale alespoň počet bitů size_t
+ */
+void generateRMat(Graph& graph, size_t scale, size_t edgeCount, uint64_t seed,
+                  double a = 0.57, double b = 0.19, double c = 0.19);
+
+/**
+ * @brief Vygeneruje bezškálový graf podle Barabásiho a Albertové.
+ *
+ * Začíná úplným grafem na @p edgesPerNode + 1 uzlech, každý další uzel se
+ * připojí k @p edgesPerNode různým uzlům vybraným úměrně jejich stupni.
+ *
+ * @param[in, out] graph graf, do kterého se hrany přidají
+ * @param[in] nodeCount počet uzlů
+ * @param[in] edgesPerNode počet hran přidaných s každým novým uzlem
+ * @param[in] seed semínko generátoru náhodných čísel
+ */
+void generateBarabasiAlbert(Graph& graph, size_t nodeCount, size_t edgesPerNode, uint64_t seed);
+
+/**
+ * @brief Vygeneruje mřížku @p rows x @p columns se 4-okolím.
+ *
+ * Uzel v řádku r a sloupci c má id r * columns + c.
+ *
+ * @param[in, out] graph graf, do kterého se hrany přidají
+ * @param[in] rows počet řádků
+ * @param[in] columns počet sloupců
+ */
+void generateGrid(Graph& graph, size_t rows, size_t columns);
+
+/**
+ * @brief Vygeneruje úplný k-partitní graf.
+ *
+ * Partity tvoří po sobě jdoucí rozsahy id, hrana vede mezi každými dvěma
+ * uzly z různých partit. Chromatické číslo takového grafu je rovno počtu
+ * neprázdných partit.
+ *
+ * @param[in, out] graph graf, do kterého se hrany přidají
+ * @param[in] partSizes velikosti jednotlivých partit
+ */
+void generateCompleteMultipartite(Graph& graph, const std::vector<size_t>& partSizes);
+
 #endif // TDD_CODE_H_
 
 /*** Konec souboru tdd_code.h ***/
\ No newline at end of file
@@ -19,8 +19,48 @@
 #include <gmock/gmock.h>
 #include "tdd_code.h"
 
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
 using namespace ::testing;
 
+/**
+ * @brief Ověří, že sousední uzly mají různé nenulové barvy a počet barev nepřesáhne limit.
+ * @param graph obarvený graf
+ * @param maxColors maximální povolený počet barev
+ */
+static void expectValidColoring(Graph& graph, size_t maxColors){
+    std::set<size_t> colors;
+    for (auto node : graph.nodes()){
+        EXPECT_NE(node->color, 0);
+        colors.insert(node->color);
+    }
+    EXPECT_LE(colors.size(), maxColors);
+
+    for (auto edge : graph.edges()){
+        EXPECT_NE(graph.getNode(edge.a)->color, graph.getNode(edge.b)->color);
+    }
+}
+
+/**
+ * @brief Ověří, že vybrané uzly ve vzdálenosti nejvýše 2 mají různé nenulové barvy.
+ * @param graph obarvený graf
+ * @param nodeIds id vybraných uzlů
+ */
+static void expectDistance2Coloring(Graph& graph, const std::vector<size_t>& nodeIds){
+    for (size_t i = 0; i < nodeIds.size(); ++i){
+        EXPECT_NE(graph.getNode(nodeIds[i])->color, 0);
+        for (size_t j = i + 1; j < nodeIds.size(); ++j){
+            if (graph.containsEdge(Edge(nodeIds[i], nodeIds[j])) ||
+                !graph.commonNeighbors(nodeIds[i], nodeIds[j]).empty()){
+                EXPECT_NE(graph.getNode(nodeIds[i])->color, graph.getNode(nodeIds[j])->color);
+            }
+        }
+    }
+}
+
 /**
  * @brief Fixture pro testy nad neprázdným grafem.
  */
@@ -234,6 +274,118 @@ TEST_F(NonEmptyGraph, clear){
     EXPECT_EQ(edges.size(), 0);
 }
 
+TEST_F(NonEmptyGraph, sortedAdjacency){
+    EXPECT_FALSE(graph.sortedAdjacency());
+    graph.setSortedAdjacency(true);
+    EXPECT_TRUE(graph.sortedAdjacency());
+
+    EXPECT_TRUE(graph.addEdge(Edge(6, 1)));
+    EXPECT_FALSE(graph.addEdge(Edge(1, 6)));
+    EXPECT_TRUE(graph.containsEdge(Edge(1, 6)));
+    EXPECT_TRUE(graph.containsEdge(Edge(7, 5)));
+    EXPECT_FALSE(graph.containsEdge(Edge(1, 7)));
+
+    graph.removeEdge(Edge(1, 6));
+    EXPECT_FALSE(graph.containsEdge(Edge(6, 1)));
+    graph.removeNode(5);
+    EXPECT_FALSE(graph.containsEdge(Edge(1, 5)));
+    EXPECT_EQ(graph.nodeDegree(6), 2);
+}
+
+TEST_F(NonEmptyGraph, commonNeighbors){
+    EXPECT_THAT(graph.commonNeighbors(5, 6), ElementsAre(7));
+    EXPECT_THAT(graph.commonNeighbors(1, 6), ElementsAre(4, 5));
+    EXPECT_THAT(graph.commonNeighbors(1, 7), ElementsAre(5));
+    EXPECT_THAT(graph.commonNeighbors(4, 5), ElementsAre(1, 6));
+
+    graph.setSortedAdjacency(true);
+    EXPECT_THAT(graph.commonNeighbors(6, 1), ElementsAre(4, 5));
+    EXPECT_THROW(graph.commonNeighbors(1, 9), std::out_of_range);
+}
+
+TEST_F(NonEmptyGraph, triangleCount){
+    EXPECT_EQ(graph.triangleCount(), 1);
+
+    graph.addMultipleEdges({{1, 6}, {4, 5}});
+    // K4 na uzlech 1, 4, 5, 6 a trojúhelník 5, 6, 7
+    EXPECT_EQ(graph.triangleCount(), 5);
+
+    graph.setSortedAdjacency(true);
+    EXPECT_EQ(graph.triangleCount(), 5);
+}
+
+TEST_F(NonEmptyGraph, subgraphView){
+    graph.getNode(7)->color = 42;
+    SubgraphView view(graph, {1, 4, 5, 6});
+
+    EXPECT_EQ(view.nodeCount(), 4);
+    EXPECT_EQ(view.edgeCount(), 4);
+    EXPECT_TRUE(view.containsNode(5));
+    EXPECT_FALSE(view.containsNode(7));
+    EXPECT_EQ(view.nodeDegree(5), 2);
+    EXPECT_EQ(view.graphDegree(), 2);
+    EXPECT_THAT(view.neighbors(6), UnorderedElementsAre(4, 5));
+    EXPECT_THAT(view.edges(), UnorderedElementsAre(Eq(Edge(1, 4)), Eq(Edge(1, 5)), Eq(Edge(4, 6)), Eq(Edge(5, 6))));
+    EXPECT_THROW(view.nodeDegree(7), std::out_of_range);
+
+    view.coloring();
+    EXPECT_EQ(graph.getNode(7)->color, 42);
+    for (const Edge& edge : view.edges()){
+        EXPECT_NE(graph.getNode(edge.a)->color, graph.getNode(edge.b)->color);
+    }
+
+    view.materialize();
+    EXPECT_TRUE(view.materialized());
+    EXPECT_EQ(view.edgeCount(), 4);
+    EXPECT_EQ(view.nodeDegree(1), 2);
+    EXPECT_THAT(view.neighbors(6), UnorderedElementsAre(4, 5));
+
+    SubgraphView triangle(graph, [](const Node& node){ return node.id >= 5; });
+    EXPECT_EQ(triangle.nodeCount(), 3);
+    EXPECT_EQ(triangle.edgeCount(), 3);
+    triangle.coloring();
+    std::set<size_t> colors;
+    for (auto node : triangle.nodes()){
+        colors.insert(node->color);
+    }
+    EXPECT_EQ(colors.size(), 3);
+
+    EXPECT_THROW(SubgraphView(graph, std::vector<size_t>{1, 9}), std::out_of_range);
+}
+
+TEST_F(NonEmptyGraph, lazyEdgeDeletion){
+    graph.setLazyEdgeDeletion(true, 0.5);
+    EXPECT_TRUE(graph.lazyEdgeDeletion());
+
+    graph.removeEdge(Edge(6, 4));
+    EXPECT_EQ(graph.edgeCount(), 5);
+    EXPECT_FALSE(graph.containsEdge(Edge(4, 6)));
+    EXPECT_THAT(graph.edges(), UnorderedElementsAre(Eq(Edge(1, 4)), Eq(Edge(1, 5)), Eq(Edge(5, 6)),
+                                                    Eq(Edge(5, 7)), Eq(Edge(7, 6))));
+    EXPECT_THROW(graph.removeEdge(Edge(4, 6)), std::out_of_range);
+
+    // znovu přidaná hrana je živá a lze ji opět odebrat
+    EXPECT_TRUE(graph.addEdge(Edge(4, 6)));
+    EXPECT_EQ(graph.edgeCount(), 6);
+    graph.removeEdge(Edge(4, 6));
+
+    graph.removeNode(5);
+    EXPECT_EQ(graph.edgeCount(), 2);
+    EXPECT_THAT(graph.edges(), UnorderedElementsAre(Eq(Edge(1, 4)), Eq(Edge(7, 6))));
+    EXPECT_EQ(graph.nodeDegree(1), 1);
+    EXPECT_EQ(graph.nodeDegree(6), 1);
+
+    auto matchings = graph.edgeColoring();
+    EXPECT_EQ(matchings.size(), 1);
+    EXPECT_EQ(graph.edgeColor(Edge(6, 7)), 1);
+
+    graph.setLazyEdgeDeletion(false);
+    EXPECT_FALSE(graph.lazyEdgeDeletion());
+    graph.removeEdge(Edge(1, 4));
+    EXPECT_THAT(graph.edges(), ElementsAre(Eq(Edge(7, 6))));
+    EXPECT_THROW(graph.setLazyEdgeDeletion(true, 0.0), std::invalid_argument);
+}
+
 TEST_F(EmptyGraph, nodes){
     auto nodes = graph.nodes();
     EXPECT_EQ(nodes.size(), 0);
@@ -331,6 +483,559 @@ TEST_F(EmptyGraph, clear){
     EXPECT_EQ(edges.size(), 0);
 }
 
+TEST_F(EmptyGraph, commonNeighbors){
+    EXPECT_THROW(graph.commonNeighbors(1, 2), std::out_of_range);
+}
+
+TEST_F(EmptyGraph, triangleCount){
+    EXPECT_EQ(graph.triangleCount(), 0);
+}
+
+TEST(Generators, erdosRenyi){
+    Graph first;
+    Graph second;
+    generateErdosRenyi(first, 200, 0.05, 42);
+    generateErdosRenyi(second, 200, 0.05, 42);
+
+    EXPECT_EQ(first.nodeCount(), 200);
+    EXPECT_GT(first.edgeCount(), 0);
+    EXPECT_EQ(first.edges(), second.edges());
+
+    Graph complete;
+    generateErdosRenyi(complete, 10, 1.0, 0);
+    EXPECT_EQ(complete.edgeCount(), 45);
+
+    // pravděpodobnost pod přesností 1 - p nesmí vést k nekonečné mezeře
+    Graph sparse;
+    generateErdosRenyi(sparse, 1000, 1e-300, 5);
+    EXPECT_EQ(sparse.nodeCount(), 1000);
+    EXPECT_EQ(sparse.edgeCount(), 0);
+    generateErdosRenyi(sparse, 1000, 1e-17, 5);
+    EXPECT_EQ(sparse.edgeCount(), 0);
+
+    // hromadné vkládání zachová seřazené seznamy sousedů
+    Graph sorted;
+    sorted.setSortedAdjacency(true);
+    generateErdosRenyi(sorted, 200, 0.05, 42);
+    EXPECT_EQ(sorted.edges(), first.edges());
+    EXPECT_EQ(sorted.commonNeighbors(3, 17), first.commonNeighbors(3, 17));
+    for (const Edge& edge : first.edges()){
+        EXPECT_TRUE(sorted.containsEdge(edge));
+    }
+
+    // do grafu s hranami se vygenerované hrany vkládají s kontrolou duplicit
+    generateErdosRenyi(sorted, 200, 0.05, 42);
+    EXPECT_EQ(sorted.edges(), first.edges());
+}
+
+TEST(Generators, rMat){
+    Graph first;
+    Graph second;
+    generateRMat(first, 8, 1000, 7);
+    generateRMat(second, 8, 1000, 7);
+
+    EXPECT_LE(first.edgeCount(), 1000);
+    EXPECT_EQ(first.edges(), second.edges());
+    for (auto node : first.nodes()){
+        EXPECT_LT(node->id, 256);
+    }
+
+    Graph tooWide;
+    EXPECT_THROW(generateRMat(tooWide, 64, 10, 7), std::invalid_argument);
+}
+
+TEST(Generators, barabasiAlbert){
+    Graph graph;
+    generateBarabasiAlbert(graph, 100, 3, 1);
+
+    EXPECT_EQ(graph.nodeCount(), 100);
+    // úplný graf na 4 uzlech a 3 hrany za každý další uzel
+    EXPECT_EQ(graph.edgeCount(), 6 + 96 * 3);
+}
+
+TEST(Generators, grid){
+    Graph graph;
+    generateGrid(graph, 3, 4);
+
+    EXPECT_EQ(graph.nodeCount(), 12);
+    EXPECT_EQ(graph.edgeCount(), 3 * 3 + 2 * 4);
+    EXPECT_TRUE(graph.containsEdge(Edge(0, 1)));
+    EXPECT_TRUE(graph.containsEdge(Edge(1, 5)));
+    EXPECT_FALSE(graph.containsEdge(Edge(3, 4)));
+}
+
+TEST(Generators, completeMultipartite){
+    Graph graph;
+    generateCompleteMultipartite(graph, {2, 3, 4});
+
+    EXPECT_EQ(graph.nodeCount(), 9);
+    EXPECT_EQ(graph.edgeCount(), 2 * 3 + 2 * 4 + 3 * 4);
+    EXPECT_FALSE(graph.containsEdge(Edge(0, 1)));
+    EXPECT_TRUE(graph.containsEdge(Edge(0, 2)));
+}
+
+TEST(Coloring, denseMatrix){
+    // výchozí nastavení sestaví matici automaticky po překročení prahu hustoty
+    Graph dense;
+    Graph lists;
+    EXPECT_FALSE(dense.denseMatrixActive());
+    lists.setDenseMatrixPolicy(0.3, 0);
+    generateErdosRenyi(dense, 300, 0.5, 8);
+    generateErdosRenyi(lists, 300, 0.5, 8);
+    EXPECT_TRUE(dense.denseMatrixActive());
+    EXPECT_FALSE(lists.denseMatrixActive());
+
+    EXPECT_EQ(dense.containsEdge(Edge(3, 17)), lists.containsEdge(Edge(3, 17)));
+    EXPECT_EQ(dense.commonNeighbors(3, 17), lists.commonNeighbors(3, 17));
+    EXPECT_EQ(dense.triangleCount(), lists.triangleCount());
+
+    // barvení nad maticí dává stejný výsledek jako nad seznamy sousedů
+    dense.coloring();
+    lists.coloring();
+    expectValidColoring(dense, dense.graphDegree() + 1);
+    for (Node* node : dense.nodes()){
+        EXPECT_EQ(node->color, lists.getNode(node->id)->color);
+    }
+
+    // přidání uzlů za rezervu matice matici přestaví, odebrání uzlu jen vynuluje jeho řádek
+    for (size_t i = 300; i < 500; ++i){
+        dense.addEdge(Edge(i, i - 300));
+        dense.addEdge(Edge(i, i - 1));
+        lists.addEdge(Edge(i, i - 300));
+        lists.addEdge(Edge(i, i - 1));
+    }
+    dense.removeNode(0);
+    lists.removeNode(0);
+    EXPECT_TRUE(dense.denseMatrixActive());
+    EXPECT_EQ(dense.commonNeighbors(300, 1), lists.commonNeighbors(300, 1));
+    EXPECT_EQ(dense.triangleCount(), lists.triangleCount());
+    EXPECT_TRUE(dense.containsEdge(Edge(450, 150)));
+    EXPECT_FALSE(dense.containsEdge(Edge(450, 151)));
+    dense.removeEdge(Edge(450, 150));
+    EXPECT_FALSE(dense.containsEdge(Edge(450, 150)));
+    dense.coloring();
+    expectValidColoring(dense, dense.graphDegree() + 1);
+
+    // pokles hustoty pod polovinu prahu matici zruší
+    dense.setDenseMatrixPolicy(1.0, 4096);
+    EXPECT_FALSE(dense.denseMatrixActive());
+    EXPECT_THROW(dense.setDenseMatrixPolicy(0.0, 4096), std::invalid_argument);
+}
+
+TEST(Coloring, generatedGraphs){
+    Graph random;
+    generateErdosRenyi(random, 500, 0.1, 3);
+    random.coloring();
+    expectValidColoring(random, random.graphDegree() + 1);
+
+    // maska barev přesahuje jedno 64bitové slovo
+    Graph complete;
+    generateErdosRenyi(complete, 150, 1.0, 0);
+    complete.coloring();
+    expectValidColoring(complete, 150);
+
+    Graph multipartite;
+    generateCompleteMultipartite(multipartite, {5, 3, 7, 1});
+    multipartite.coloring();
+    expectValidColoring(multipartite, 4);
+}
+
+TEST(Coloring, improveColoring){
+    // Korunový graf s prokládanými id, hladové barvení podle id potřebuje n barev
+    Graph crown;
+    for (size_t i = 0; i < 8; ++i){
+        for (size_t j = 0; j < 8; ++j){
+            if (i != j){
+                crown.addEdge(Edge(2 * i, 2 * j + 1));
+            }
+        }
+    }
+    crown.coloring();
+    expectValidColoring(crown, 8);
+
+    EXPECT_EQ(crown.improveColoring(100, std::chrono::milliseconds(0), 1), 2);
+    expectValidColoring(crown, 2);
+
+    Graph random;
+    generateErdosRenyi(random, 300, 0.1, 5);
+    random.coloring();
+    std::set<size_t> greedyColors;
+    for (auto node : random.nodes()){
+        greedyColors.insert(node->color);
+    }
+
+    size_t improved = random.improveColoring(0, std::chrono::milliseconds(50), 4);
+    EXPECT_LE(improved, greedyColors.size());
+    expectValidColoring(random, improved);
+
+    EXPECT_THROW(random.improveColoring(0), std::invalid_argument);
+}
+
+TEST(Coloring, improveColoring_Deadline){
+    Graph dense;
+    generateErdosRenyi(dense, 2000, 0.2, 3);
+    dense.coloring();
+
+    // Limit se hlídá i uvnitř kroku, výsledek zůstává platný
+    auto start = std::chrono::steady_clock::now();
+    size_t colors = dense.improveColoring(0, std::chrono::milliseconds(1), 1);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+    expectValidColoring(dense, colors);
+}
+
+TEST(Coloring, executeByColor){
+    Graph grid;
+    generateGrid(grid, 20, 30);
+
+    std::vector<std::atomic<int>> active(600);
+    std::vector<std::atomic<int>> visits(600);
+    std::atomic<bool> conflict(false);
+
+    auto stats = grid.executeByColor([&](Node* node){
+        size_t row = node->id / 30;
+        size_t column = node->id % 30;
+        active[node->id] = 1;
+        visits[node->id]++;
+        if ((column > 0 && active[node->id - 1]) || (column < 29 && active[node->id + 1]) ||
+            (row > 0 && active[node->id - 30]) || (row < 19 && active[node->id + 30])){
+            conflict = true;
+        }
+        active[node->id] = 0;
+    }, 4, 8);
+
+    EXPECT_FALSE(conflict);
+    for (auto& count : visits){
+        EXPECT_EQ(count, 1);
+    }
+
+    size_t processed = 0;
+    for (size_t i = 0; i < stats.size(); ++i){
+        processed += stats[i].nodeCount;
+        if (i > 0){
+            EXPECT_LT(stats[i - 1].color, stats[i].color);
+        }
+    }
+    EXPECT_EQ(processed, 600);
+    EXPECT_LE(stats.size(), grid.graphDegree() + 1);
+
+    Graph empty;
+    EXPECT_TRUE(empty.executeByColor([](Node*){}).empty());
+}
+
+TEST(Coloring, distance2Coloring){
+    Graph path;
+    path.addMultipleEdges({{0, 1}, {1, 2}, {2, 3}, {3, 4}});
+    path.distance2Coloring();
+    expectDistance2Coloring(path, {0, 1, 2, 3, 4});
+
+    std::set<size_t> colors;
+    for (auto node : path.nodes()){
+        colors.insert(node->color);
+    }
+    EXPECT_EQ(colors.size(), 3);
+
+    Graph random;
+    generateErdosRenyi(random, 150, 0.03, 11);
+    std::vector<size_t> ids;
+    for (auto node : random.nodes()){
+        ids.push_back(node->id);
+    }
+
+    random.distance2Coloring(1);
+    expectDistance2Coloring(random, ids);
+
+    random.distance2Coloring(4);
+    expectDistance2Coloring(random, ids);
+}
+
+TEST(Coloring, partialDistance2Coloring){
+    // Řádky 0 až 2, sloupce 10 až 13 řídké matice
+    Graph jacobian;
+    jacobian.addMultipleEdges({{0, 10}, {0, 11}, {1, 11}, {1, 12}, {2, 13}});
+
+    jacobian.partialDistance2Coloring({10, 11, 12, 13});
+    expectDistance2Coloring(jacobian, {10, 11, 12, 13});
+    EXPECT_EQ(jacobian.getNode(0)->color, 0);
+
+    std::set<size_t> colors;
+    for (size_t column : {10, 11, 12, 13}){
+        colors.insert(jacobian.getNode(column)->color);
+    }
+    EXPECT_EQ(colors.size(), 2);
+
+    jacobian.partialDistance2Coloring({10, 11, 12, 13}, 3);
+    expectDistance2Coloring(jacobian, {10, 11, 12, 13});
+
+    EXPECT_THROW(jacobian.partialDistance2Coloring({10, 99}), std::out_of_range);
+}
+
+/**
+ * @brief Ověří, že každá třída barev hran je párování a obsahuje všechny hrany.
+ * @param graph graf s obarvenými hranami
+ * @param matchings párování vrácená edgeColoring
+ */
+static void expectEdgeColoring(Graph& graph, const std::vector<std::vector<Edge>>& matchings){
+    size_t total = 0;
+    for (size_t color = 0; color < matchings.size(); ++color){
+        std::set<size_t> endpoints;
+        for (const Edge& edge : matchings[color]){
+            EXPECT_TRUE(endpoints.insert(edge.a).second);
+            EXPECT_TRUE(endpoints.insert(edge.b).second);
+            EXPECT_EQ(graph.edgeColor(edge), color + 1);
+        }
+        total += matchings[color].size();
+    }
+    EXPECT_EQ(total, graph.edgeCount());
+}
+
+TEST_F(NonEmptyGraph, edgeColoring){
+    auto matchings = graph.edgeColoring();
+    expectEdgeColoring(graph, matchings);
+    EXPECT_LE(matchings.size(), graph.graphDegree() + 1);
+
+    graph.removeEdge(Edge(5, 7));
+    EXPECT_THROW(graph.edgeColor(Edge(5, 7)), std::out_of_range);
+    EXPECT_NE(graph.edgeColor(Edge(7, 6)), 0);
+
+    graph.addEdge(Edge(1, 7));
+    EXPECT_EQ(graph.edgeColor(Edge(1, 7)), 0);
+}
+
+TEST(EdgeColoring, misraGries){
+    for (uint64_t seed = 0; seed < 5; ++seed){
+        Graph graph;
+        generateErdosRenyi(graph, 120, 0.1, seed);
+        auto matchings = graph.edgeColoring(EdgeColoringMethod::MISRA_GRIES);
+        expectEdgeColoring(graph, matchings);
+        EXPECT_LE(matchings.size(), graph.graphDegree() + 1);
+    }
+
+    Graph complete;
+    generateErdosRenyi(complete, 9, 1.0, 0);
+    auto matchings = complete.edgeColoring();
+    expectEdgeColoring(complete, matchings);
+    EXPECT_EQ(matchings.size(), 9);
+}
+
+TEST(EdgeColoring, greedy){
+    Graph graph;
+    generateBarabasiAlbert(graph, 300, 4, 2);
+    auto matchings = graph.edgeColoring(EdgeColoringMethod::GREEDY);
+    expectEdgeColoring(graph, matchings);
+    EXPECT_LE(matchings.size(), 2 * graph.graphDegree() - 1);
+
+    Graph empty;
+    EXPECT_TRUE(empty.edgeColoring().empty());
+}
+
+TEST(ExternalColoring, shards){
+    Graph graph;
+    generateErdosRenyi(graph, 400, 0.05, 9);
+    graph.addNode(1000);
+
+    std::string edgeFile = testing::TempDir() + "external_edges.txt";
+    std::string colorFile = testing::TempDir() + "external_colors.txt";
+    {
+        std::ofstream output(edgeFile);
+        output << "# seznam hran\n";
+        for (const Edge& edge : graph.edges()){
+            output << edge.a << " " << edge.b << "\n";
+        }
+        output << "1000 1000\n";
+        // Záporné id není hranou, nesmí přetéct na obří id
+        output << "-1 3\n";
+    }
+
+    ExternalColoringOptions options;
+    options.memoryBudget = 1024;
+    options.tempDirectory = testing::TempDir();
+    ExternalColoringStats stats = externalColoring(edgeFile, colorFile, options);
+
+    EXPECT_EQ(stats.nodeCount, 401);
+    EXPECT_EQ(stats.edgeCount, graph.edgeCount());
+    EXPECT_GT(stats.shardCount, 64);
+    EXPECT_EQ(stats.maxDegree, graph.graphDegree());
+    EXPECT_LE(stats.colorCount, graph.graphDegree() + 1);
+
+    std::map<size_t, size_t> colors;
+    std::ifstream input(colorFile);
+    size_t nodeId;
+    size_t color;
+    while (input >> nodeId >> color){
+        colors[nodeId] = color;
+    }
+    EXPECT_EQ(colors.size(), 401);
+    EXPECT_EQ(colors[1000], 1);
+    for (const Edge& edge : graph.edges()){
+        EXPECT_NE(colors[edge.a], colors[edge.b]);
+    }
+
+    EXPECT_THROW(externalColoring(testing::TempDir() + "missing_edges.txt", colorFile), std::runtime_error);
+
+    // Dočasný adresář segmentů po sobě nic nezanechá
+    for (const auto& entry : std::filesystem::directory_iterator(testing::TempDir())){
+        EXPECT_NE(entry.path().filename().string().rfind("graph_shard", 0), 0u);
+    }
+
+    options.tempDirectory = testing::TempDir() + "missing_directory/nested";
+    EXPECT_THROW(externalColoring(edgeFile, colorFile, options), std::runtime_error);
+}
+
+TEST(Coloring, distributedColoring){
+    Graph graph;
+    generateErdosRenyi(graph, 300, 0.05, 13);
+
+    auto stats = graph.distributedColoring(4);
+    expectValidColoring(graph, graph.graphDegree() + 1);
+    for (auto node : graph.nodes()){
+        EXPECT_LE(node->color, graph.nodeDegree(node->id) + 1);
+    }
+
+    ASSERT_FALSE(stats.empty());
+    EXPECT_EQ(stats.front().round, 1);
+    EXPECT_EQ(stats.back().conflicts, 0);
+    EXPECT_GT(stats.front().bytesSent, 0);
+    EXPECT_GT(stats.front().bytesReceived, 0);
+
+    Graph small;
+    small.addMultipleEdges({{1, 2}, {2, 3}});
+    small.distributedColoring(8);
+    expectValidColoring(small, 3);
+
+    EXPECT_THROW(small.distributedColoring(0), std::invalid_argument);
+}
+
+TEST(GraphLoader, loadEdgeList){
+    Graph source;
+    generateBarabasiAlbert(source, 2000, 3, 4);
+
+    std::string edgeFile = testing::TempDir() + "loader_edges.txt";
+    {
+        std::ofstream output(edgeFile);
+        output << "# komentář\n\n";
+        for (const Edge& edge : source.edges()){
+            output << edge.a << "\t" << edge.b << "\r\n";
+        }
+        output << "5 5\n";
+        output << source.edges().front().b << " " << source.edges().front().a;
+    }
+
+    GraphLoaderOptions options;
+    options.blockSize = 61;
+    options.queueCapacity = 2;
+    size_t progressCalls = 0;
+    GraphLoaderProgress last{0, 0, 0};
+    options.progress = [&](const GraphLoaderProgress& progress){
+        EXPECT_GE(progress.edgesInserted, last.edgesInserted);
+        last = progress;
+        ++progressCalls;
+    };
+
+    Graph graph;
+    EXPECT_EQ(loadEdgeList(graph, edgeFile, options), source.edgeCount());
+    EXPECT_EQ(graph.edges(), source.edges());
+    EXPECT_GT(progressCalls, 1);
+    EXPECT_EQ(last.edgesInserted, source.edgeCount());
+    EXPECT_EQ(last.edgesParsed, source.edgeCount() + 2);
+
+    EXPECT_THROW(loadEdgeList(graph, testing::TempDir() + "missing_edges.txt"), std::runtime_error);
+
+    // Přetečení id se z vlákna parseru předá volajícímu
+    {
+        std::ofstream output(edgeFile, std::ios::trunc);
+        output << "1 2\n99999999999999999999999 1\n";
+    }
+    EXPECT_THROW(loadEdgeList(graph, edgeFile, options), std::out_of_range);
+}
+
+TEST(GraphChangeLog, replay){
+    GraphChangeLog log;
+    Graph graph;
+    graph.attachChangeLog(&log);
+    graph.addMultipleEdges({{1, 2}, {2, 3}, {3, 1}, {3, 300}});
+    graph.addNode(7);
+    graph.removeEdge(Edge(1, 2));
+    graph.coloring();
+
+    Graph replica;
+    size_t replicated = log.replay(replica, 0);
+    EXPECT_EQ(replicated, log.offset());
+    EXPECT_EQ(replica.edges(), graph.edges());
+    EXPECT_EQ(replica.nodeCount(), 5);
+    for (Node* node : graph.nodes()){
+        EXPECT_EQ(replica.getNode(node->id)->color, node->color);
+    }
+
+    // opakované barvení se stejným výsledkem do záznamu nic nepřidá
+    graph.coloring();
+    EXPECT_EQ(log.offset(), replicated);
+
+    // replika přenáší jen změny od posledního offsetu
+    graph.removeNode(3);
+    graph.addEdge(Edge(1, 7));
+    std::vector<uint8_t> delta = log.read(replicated);
+    EXPECT_EQ(delta.size(), 2 + 3);
+    GraphChangeLog::apply(replica, delta);
+    replicated = log.offset();
+    EXPECT_EQ(replica.edges(), graph.edges());
+    EXPECT_EQ(replica.getNode(3), nullptr);
+
+    // po zhutnění se zaostalá replika obnoví ze snímku
+    std::vector<uint8_t> snapshot = GraphChangeLog::snapshot(graph);
+    log.compact(log.offset());
+    EXPECT_EQ(log.baseOffset(), replicated);
+    EXPECT_THROW(log.read(0), std::out_of_range);
+
+    graph.clear();
+    graph.addEdge(Edge(5, 6));
+    Graph lagging;
+    lagging.addEdge(Edge(8, 9));
+    GraphChangeLog::apply(lagging, snapshot);
+    EXPECT_EQ(lagging.edges(), std::vector<Edge>({Edge(1, 7)}));
+    EXPECT_EQ(lagging.nodeCount(), 4);
+    log.replay(lagging, log.baseOffset());
+    EXPECT_EQ(lagging.edges(), graph.edges());
+    EXPECT_EQ(lagging.nodeCount(), 2);
+
+    EXPECT_THROW(GraphChangeLog::apply(lagging, std::vector<uint8_t>({2, 0x81})), std::runtime_error);
+    EXPECT_THROW(GraphChangeLog::apply(lagging, std::vector<uint8_t>({42})), std::runtime_error);
+}
+
+TEST(NamedGraph, interning){
+    NamedGraph named;
+    EXPECT_EQ(named.intern("praha"), 0);
+    EXPECT_EQ(named.intern("brno"), 1);
+    EXPECT_EQ(named.intern("praha"), 0);
+
+    std::string ostrava("ostrava");
+    EXPECT_TRUE(named.addEdge(ostrava.c_str(), "brno"));
+    EXPECT_FALSE(named.addEdge("brno", "ostrava"));
+    named.addMultipleEdges({{"praha", "brno"}, {"praha", "plzen"}, {"plzen", "plzen"}});
+    ostrava.assign("zlin");
+
+    EXPECT_EQ(named.nameCount(), 4);
+    EXPECT_STREQ(named.name(2), "ostrava");
+    EXPECT_EQ(named.id("plzen"), 3);
+    EXPECT_TRUE(named.contains("ostrava"));
+    EXPECT_FALSE(named.contains("zlin"));
+    EXPECT_THROW(named.id("zlin"), std::out_of_range);
+    EXPECT_THROW(named.name(4), std::out_of_range);
+
+    Graph& graph = named.graph();
+    EXPECT_EQ(graph.nodeCount(), 4);
+    EXPECT_EQ(graph.edgeCount(), 3);
+    EXPECT_TRUE(graph.containsEdge(Edge(named.id("brno"), named.id("praha"))));
+    EXPECT_EQ(graph.nodeDegree(named.id("praha")), 2);
+
+    // zpětný převod zůstává platný i po realokaci tabulky
+    for (size_t i = 0; i < 100; ++i){
+        named.intern(("uzel" + std::to_string(i)).c_str());
+    }
+    EXPECT_STREQ(named.name(0), "praha");
+    EXPECT_STREQ(named.name(103), "uzel99");
+    EXPECT_EQ(named.id("uzel42"), 46);
+}
 
 TEST(Edges, equal){
     EXPECT_TRUE(Edge(1, 4)==Edge(1, 4));
@@ -17,349 +17,1795 @@
 
 #include "white_box_code.h"
 #include <stdio.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*******************************************************************************
+ * Pomocné metody.
+ ******************************************************************************/
+/** Konstanty hašovací funkce wyhash. */
+static const uint64_t WYHASH_SECRET[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+    0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+/**
+ * @brief Vynásobí dvě 64bitová čísla na 128 bitů.
+ *
+ * @param[in, out] a Činitel, po návratu dolních 64 bitů součinu.
+ * @param[in, out] b Činitel, po návratu horních 64 bitů součinu.
+ */
+static inline void wyhash_mum(uint64_t* a, uint64_t* b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/**
+ * @brief Promíchá dvě čísla 128bitovým násobením.
+ *
+ * @return Dolní a horní polovina součinu spojené operací xor.
+ */
+static inline uint64_t wyhash_mix(uint64_t a, uint64_t b)
+{
+    wyhash_mum(&a, &b);
+    return a ^ b;
+}
+
+/** @brief Přečte 8 bajtů bez požadavku na zarovnání. */
+static inline uint64_t wyhash_read8(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+/** @brief Přečte 4 bajty bez požadavku na zarovnání. */
+static inline uint64_t wyhash_read4(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+size_t hash_map_wyhash(const char* key, size_t length, size_t seed)
+{
+    const uint8_t* p = (const uint8_t*)key;
+    uint64_t s = (uint64_t)seed ^ wyhash_mix((uint64_t)seed ^ WYHASH_SECRET[0],
+                                             WYHASH_SECRET[1]);
+    uint64_t a, b;
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            // dve prekryvajici se ctverice z kazdeho konce klice
+            size_t shift = (length >> 3) << 2;
+            a = (wyhash_read4(p) << 32) | wyhash_read4(p + shift);
+            b = (wyhash_read4(p + length - 4) << 32) |
+                wyhash_read4(p + length - 4 - shift);
+        }
+        else if (length > 0)
+        {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) |
+                p[length - 1];
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t i = length;
+        if (i > 48)
+        {
+            // tri nezavisle proudy, aby nasobeni mohla bezet soubezne
+            uint64_t s1 = s, s2 = s;
+            do
+            {
+                s = wyhash_mix(wyhash_read8(p) ^ WYHASH_SECRET[1],
+                               wyhash_read8(p + 8) ^ s);
+                s1 = wyhash_mix(wyhash_read8(p + 16) ^ WYHASH_SECRET[2],
+                                wyhash_read8(p + 24) ^ s1);
+                s2 = wyhash_mix(wyhash_read8(p + 32) ^ WYHASH_SECRET[3],
+                                wyhash_read8(p + 40) ^ s2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            s ^= s1 ^ s2;
+        }
+        while (i > 16)
+        {
+            s = wyhash_mix(wyhash_read8(p) ^ WYHASH_SECRET[1],
+                           wyhash_read8(p + 8) ^ s);
+            p += 16;
+            i -= 16;
+        }
+        a = wyhash_read8(p + i - 16);
+        b = wyhash_read8(p + i - 8);
+    }
+
+    a ^= WYHASH_SECRET[1];
+    b ^= s;
+    wyhash_mum(&a, &b);
+    return (size_t)wyhash_mix(a ^ WYHASH_SECRET[0] ^ length, b ^ WYHASH_SECRET[1]);
+}
+
+size_t hash_map_additive_hash(const char* key, size_t length, size_t seed)
+{
+    (void)seed;
+    size_t hash = 0;
+
+    for (size_t idx = 0; idx < length; idx++)
+    {
+        hash += (size_t)HASH_FUNCTION_PARAM_A*(unsigned char)key[idx] + HASH_FUNCTION_PARAM_B;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Výpočet haše pro zadaný řetězec hašovací funkcí tabulky.
+ *
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] str    Klíč.
+ * @param[in] length Délka klíče.
+ * @return hash 
+ */
+size_t hash_function(hash_map_t* self, const char* str, size_t length)
+{
+    return self->hash_function(str, length, self->seed);
+}
+
+/**
+ * @brief Přidělení slotu pro položku s krátkým klíčem ze slab alokátoru.
+ *
+ * @param[in] slab Slab alokátor.
+ *
+ * @return Slot velikosti @c hash_map_item_t , v případě chyby alokace @c NULL .
+ */
+hash_map_item_t* hash_map_slab_alloc(hash_map_slab_t* slab)
+{
+    // nejprve recyklujeme uvolnene polozky
+    if (slab->free_list != NULL)
+    {
+        hash_map_item_t* item = slab->free_list;
+        slab->free_list = item->next;
+        return item;
+    }
+
+    if (slab->remaining == 0)
+    {
+        // prvni slot bloku drzi ukazatel na predchozi blok
+        hash_map_item_t* chunk = (hash_map_item_t*)malloc(
+            (slab->items_per_chunk + 1) * sizeof(hash_map_item_t));
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+        *(void**)chunk = slab->chunks;
+        slab->chunks = chunk;
+        slab->bump = chunk + 1;
+        slab->remaining = slab->items_per_chunk;
+    }
+
+    slab->remaining--;
+    return slab->bump++;
+}
+
+/**
+ * @brief Uvolnění všech bloků slab alokátoru.
+ *
+ * @param[in] slab Slab alokátor.
+ */
+void hash_map_slab_release(hash_map_slab_t* slab)
+{
+    void* chunk = slab->chunks;
+    while (chunk != NULL)
+    {
+        void* next = *(void**)chunk;
+        free(chunk);
+        chunk = next;
+    }
+
+    slab->chunks = NULL;
+    slab->free_list = NULL;
+    slab->bump = NULL;
+    slab->remaining = 0;
+}
+
+/**
+ * @brief Alokace položky s klíčem v jednom bloku paměti.
+ *
+ * Pokud má tabulka slab alokátor, položka s krátkým klíčem se přidělí z něj.
+ *
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče.
+ *
+ * @return Položka s nastaveným klíčem, v případě chyby alokace @c NULL .
+ */
+hash_map_item_t* hash_map_item_alloc(hash_map_t* self, const char* key, 
+                                     size_t length)
+{
+    hash_map_item_t* item;
+    if (self->slab != NULL && length < HASH_MAP_INLINE_KEY_SIZE)
+    {
+        item = hash_map_slab_alloc(self->slab);
+    }
+    else
+    {
+        size_t size = offsetof(hash_map_item_t, inline_key) + length + 1;
+        if (size < sizeof(hash_map_item_t))
+        {
+            size = sizeof(hash_map_item_t);
+        }
+        item = (hash_map_item_t*)malloc(size);
+        if (item != NULL && self->slab != NULL)
+        {
+            self->slab->large_items++;
+        }
+    }
+
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    // adresa klice se pocita z bloku polozky, delsi klic presahuje pole inline_key
+    char* item_key = (char*)item + offsetof(hash_map_item_t, inline_key);
+
+    // klic nemusi byt ukonceny nulou, ukoncime jej sami
+    memcpy(item_key, key, length);
+    item_key[length] = '\0';
+    item->key = item_key;
+    item->key_len = length;
+
+    return item;
+}
+
+/**
+ * @brief Uvolnění položky alokované funkcí @c hash_map_item_alloc .
+ *
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ * @param[in] item Uvolňovaná položka.
+ */
+void hash_map_item_free(hash_map_t* self, hash_map_item_t* item)
+{
+    if (self->slab == NULL)
+    {
+        free(item);
+    }
+    else if (item->key_len < HASH_MAP_INLINE_KEY_SIZE)
+    {
+        item->next = self->slab->free_list;
+        self->slab->free_list = item;
+    }
+    else
+    {
+        self->slab->large_items--;
+        free(item);
+    }
+}
+
+/** Návratová hodnota hledání, pokud klíč v tabulce není. */
+#define HASH_MAP_NOT_FOUND ((size_t)-1)
+
+/** Přednačtení paměti do cache, bez podpory překladače se nevykoná nic. */
+#if defined(__GNUC__) || defined(__clang__)
+#define HASH_MAP_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define HASH_MAP_PREFETCH(addr) ((void)0)
+#endif
+
+/**
+ * @brief Počet nulových bitů pod nejnižším nastaveným bitem masky skupiny.
+ *
+ * @param[in] mask Nenulová maska míst skupiny.
+ *
+ * @return Index prvního místa skupiny v masce.
+ */
+static inline unsigned hash_map_ctz(unsigned mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (unsigned)idx;
+#else
+    unsigned idx = 0;
+    while ((mask & 1u) == 0)
+    {
+        mask >>= 1;
+        ++idx;
+    }
+    return idx;
+#endif
+}
+
+/**
+ * @brief Bitová maska míst skupiny, jejichž řídicí bajt je roven hodnotě.
+ *
+ * @param[in] group Prvních @c HASH_MAP_GROUP_WIDTH řídicích bajtů skupiny.
+ * @param[in] value Hledaná hodnota řídicího bajtu.
+ *
+ * @return Maska, kde bit i odpovídá i-tému místu skupiny.
+ */
+static inline unsigned hash_map_group_match(const uint8_t* group, uint8_t value)
+{
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)value)));
+#else
+    unsigned mask = 0;
+    for (unsigned i = 0; i < HASH_MAP_GROUP_WIDTH; ++i)
+    {
+        mask |= (unsigned)(group[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief Bitová maska míst skupiny, která jsou prázdná nebo po odstranění.
+ *
+ * @param[in] group Prvních @c HASH_MAP_GROUP_WIDTH řídicích bajtů skupiny.
+ *
+ * @return Maska, kde bit i odpovídá i-tému místu skupiny.
+ */
+static inline unsigned hash_map_group_free(const uint8_t* group)
+{
+#ifdef __SSE2__
+    // obsazena mista maji nejvyssi bit nulovy
+    return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    unsigned mask = 0;
+    for (unsigned i = 0; i < HASH_MAP_GROUP_WIDTH; ++i)
+    {
+        mask |= (unsigned)(group[i] >> 7) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief 7bitový otisk haše ukládaný do řídicího bajtu.
+ */
+static inline uint8_t hash_map_h2(size_t hash)
+{
+    return (uint8_t)(hash & 0x7f);
+}
+
+/**
+ * @brief Počáteční místo hledání, nezávislé na bitech otisku.
+ */
+static inline size_t hash_map_h1(hash_map_t* self, size_t hash)
+{
+    return (hash >> 7) & (self->allocated - 1);
+}
+
+/**
+ * @brief Nastaví řídicí bajt místa včetně jeho kopií za koncem pole.
+ *
+ * @param[in] ctrl      Řídicí bajty indexu.
+ * @param[in] allocated Velikost indexu.
+ * @param[in] idx       Místo v indexu.
+ * @param[in] value     Nový řídicí bajt.
+ */
+static inline void hash_map_store_ctrl(uint8_t* ctrl, size_t allocated, 
+                                       size_t idx, uint8_t value)
+{
+    ctrl[idx] = value;
+    for (size_t i = idx; i < HASH_MAP_GROUP_WIDTH; i += allocated)
+    {
+        ctrl[allocated + i] = value;
+    }
+}
+
+/**
+ * @brief Nastaví řídicí bajt místa aktuálního indexu tabulky.
+ *
+ * @param[in] self  Ukazatel na strukturu hašovací tabulky.
+ * @param[in] idx   Místo v indexu.
+ * @param[in] value Nový řídicí bajt.
+ */
+static inline void hash_map_set_ctrl(hash_map_t* self, size_t idx, uint8_t value)
+{
+    hash_map_store_ctrl(self->ctrl, self->allocated, idx, value);
+}
+
+/**
+ * @brief Vyhledání položky se zadaným klíčem v jednom indexu.
+ * 
+ * Index se prochází po skupinách @c HASH_MAP_GROUP_WIDTH míst. Položka se
+ * čte jen na místech, jejichž řídicí bajt odpovídá otisku haše. Hledání
+ * končí ve skupině, která obsahuje prázdné místo, nebo po projití celého
+ * indexu. Místa s @c dummy objektem hledání nezastaví.
+ *
+ * @param[in] index     Index.
+ * @param[in] ctrl      Řídicí bajty indexu.
+ * @param[in] allocated Velikost indexu.
+ * @param[in] key       Klíč.
+ * @param[in] length    Délka klíče.
+ * @param[in] hash      Haš zadaného klíče.
+ * 
+ * @return Místo záznamu asociovaného k zadanému klíči, nebo
+ *         @c HASH_MAP_NOT_FOUND .
+ */
+static size_t hash_map_probe(hash_map_item_t** index, const uint8_t* ctrl,
+                             size_t allocated, const char* key, size_t length,
+                             size_t hash)
+{
+    size_t mask = allocated - 1;
+    size_t pos = (hash >> 7) & mask;
+    uint8_t h2 = hash_map_h2(hash);
+
+    for (size_t probed = 0; probed < allocated; probed += HASH_MAP_GROUP_WIDTH)
+    {
+        const uint8_t* group = ctrl + pos;
+        for (unsigned match = hash_map_group_match(group, h2); match != 0; match &= match - 1)
+        {
+            size_t idx = (pos + hash_map_ctz(match)) & mask;
+            hash_map_item_t* item = index[idx];
+            if (item->hash == hash && item->key_len == length &&
+                memcmp(item->key, key, length) == 0)
+            {
+                return idx;
+            }
+        }
+
+        if (hash_map_group_match(group, HASH_MAP_CTRL_EMPTY) != 0)
+        {
+            break;
+        }
+        pos = (pos + HASH_MAP_GROUP_WIDTH) & mask;
+    }
+
+    return HASH_MAP_NOT_FOUND;
+}
+
+/**
+ * @brief Nalezení volného místa pro vložení položky se zadaným hašem.
+ *
+ * Místo s @c dummy objektem je ekvivalentní prázdnému místu. Tabulka musí
+ * mít alespoň jedno volné místo, což zajišťuje mez zaplnění.
+ *
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ * @param[in] hash Haš vkládaného klíče.
+ *
+ * @return Index volného místa.
+ */
+size_t hash_map_lookup_free(hash_map_t* self, size_t hash)
+{
+    size_t mask = self->allocated - 1;
+    size_t pos = hash_map_h1(self, hash);
+
+    for (;;)
+    {
+        unsigned free_slots = hash_map_group_free(self->ctrl + pos);
+        if (free_slots != 0)
+        {
+            return (pos + hash_map_ctz(free_slots)) & mask;
+        }
+        pos = (pos + HASH_MAP_GROUP_WIDTH) & mask;
+    }
+}
+
+/**
+ * @brief Umístění položky na volné místo aktuálního indexu.
+ *
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ * @param[in] item Položka s nastaveným hašem.
+ *
+ * @return Místo položky v indexu.
+ */
+size_t hash_map_place(hash_map_t* self, hash_map_item_t* item)
+{
+    size_t idx = hash_map_lookup_free(self, item->hash);
+    if (self->index[idx] == self->dummy)
+    {
+        self->deleted--;
+    }
+    self->index[idx] = item;
+    hash_map_set_ctrl(self, idx, hash_map_h2(item->hash));
+    return idx;
+}
+
+/**
+ * @brief Uvolnění původního indexu po skončení postupné realokace.
+ *
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ */
+void hash_map_end_resize(hash_map_t* self)
+{
+    free(self->old_index);
+    free(self->old_ctrl);
+    self->old_index = NULL;
+    self->old_ctrl = NULL;
+    self->old_allocated = 0;
+    self->migrated = 0;
+}
+
+/**
+ * @brief Převedení části původního indexu do nového.
+ *
+ * Projde nejvýše @p slots míst původního indexu a jejich položky vloží do
+ * aktuálního indexu. Převedené místo se označí jako odstraněné, aby
+ * neukončilo hledání ostatních klíčů v původním indexu. Po projití celého
+ * původního indexu se index uvolní.
+ *
+ * @param[in] self  Ukazatel na strukturu hašovací tabulky.
+ * @param[in] slots Maximální počet procházených míst.
+ */
+void hash_map_migrate(hash_map_t* self, size_t slots)
+{
+    if (self->old_index == NULL)
+    {
+        return;
+    }
+
+    size_t end = self->old_allocated - self->migrated > slots ?
+                 self->migrated + slots : self->old_allocated;
+    for (; self->migrated < end; ++self->migrated)
+    {
+        // obsazena mista maji nejvyssi bit nulovy
+        if (self->old_ctrl[self->migrated] & 0x80)
+        {
+            continue;
+        }
+        hash_map_place(self, self->old_index[self->migrated]);
+        hash_map_store_ctrl(self->old_ctrl, self->old_allocated, self->migrated,
+                            HASH_MAP_CTRL_DELETED);
+    }
+
+    if (self->migrated == self->old_allocated)
+    {
+        hash_map_end_resize(self);
+    }
+}
+
+/**
+ * @brief Vyhledání položky se zadaným klíčem v tabulce.
+ * 
+ * Během postupné realokace se klíč, který není v aktuálním indexu, hledá
+ * i v původním indexu. Nalezená položka se převede do aktuálního indexu,
+ * takže volající vždy pracuje jen s aktuálním indexem.
+ *
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče.
+ * @param[in] hash   Haš zadaného klíče.
+ * 
+ * @return Index záznamu asociovaný k zadanému klíči, nebo
+ *         @c HASH_MAP_NOT_FOUND .
+ */
+size_t hash_map_lookup(hash_map_t* self, const char* key, size_t length,
+                       size_t hash)
+{
+    size_t idx = hash_map_probe(self->index, self->ctrl, self->allocated, 
+                                key, length, hash);
+    if (idx != HASH_MAP_NOT_FOUND || self->old_index == NULL)
+    {
+        return idx;
+    }
+
+    size_t old_idx = hash_map_probe(self->old_index, self->old_ctrl, 
+                                    self->old_allocated, key, length, hash);
+    if (old_idx == HASH_MAP_NOT_FOUND)
+    {
+        return HASH_MAP_NOT_FOUND;
+    }
+    // polozku prevedeme hned, dalsi operace s ni uz pracuji s novym indexem
+    hash_map_store_ctrl(self->old_ctrl, self->old_allocated, old_idx, 
+                        HASH_MAP_CTRL_DELETED);
+    return hash_map_place(self, self->old_index[old_idx]);
+}
+
+/**
+ * @brief Zahájení postupné realokace indexu.
+ *
+ * Aktuální index se stane původním indexem a alokuje se nový prázdný index.
+ * Místa s @c dummy objektem zůstanou v původním indexu. Rozpracovaná
+ * realokace se nejprve dokončí.
+ *
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ * @param[in] size Velikost nového indexu.
+ *
+ * @return @c MEMORY_ERROR v případě chyby v alokaci paměti, jinak @c OK.
+ */
+hash_map_state_code_t hash_map_start_resize(hash_map_t* self, size_t size)
+{
+    hash_map_migrate(self, SIZE_MAX);
+
+    hash_map_item_t** new_index = (hash_map_item_t**)calloc(size, sizeof(hash_map_item_t*));
+    uint8_t* new_ctrl = (uint8_t*)malloc(size + HASH_MAP_GROUP_WIDTH);
+    if (new_index == NULL || new_ctrl == NULL)
+    {
+        // alokace pameti selhala
+        free(new_index);
+        free(new_ctrl);
+        return MEMORY_ERROR;
+    }
+    memset(new_ctrl, HASH_MAP_CTRL_EMPTY, size + HASH_MAP_GROUP_WIDTH);
+
+    self->old_index = self->index;
+    self->old_ctrl = self->ctrl;
+    self->old_allocated = self->allocated;
+    self->migrated = 0;
+    self->index = new_index;
+    self->ctrl = new_ctrl;
+    self->allocated = size;
+    self->deleted = 0;
+
+    return OK;
+}
+
+/**
+ * @brief Alokuje nový index zadané velikosti a vloží do něj všechny položky.
+ *
+ * Odstraněné položky (@c dummy ) se do nového indexu nepřenáší.
+ *
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ * @param[in] size Velikost nového indexu.
+ *
+ * @return @c MEMORY_ERROR v případě chyby v alokaci paměti, jinak @c OK.
+ */
+hash_map_state_code_t hash_map_rebuild_index(hash_map_t* self, size_t size)
+{
+    hash_map_item_t** new_index = (hash_map_item_t**)malloc(size*sizeof(hash_map_t*));
+    uint8_t* new_ctrl = (uint8_t*)malloc(size + HASH_MAP_GROUP_WIDTH);
+    if (new_index == NULL || new_ctrl == NULL)
+    {
+        // alokace pameti selhala
+        free(new_index);
+        free(new_ctrl);
+        return MEMORY_ERROR;
+    }
+    // vycisteni indexu
+    for (size_t i = 0; i < size; ++i)
+    {
+        new_index[i] = NULL;
+    }
+    memset(new_ctrl, HASH_MAP_CTRL_EMPTY, size + HASH_MAP_GROUP_WIDTH);
+
+    // nahrazeni stareho indexu, indexy polozek se pocitaji uz v novem indexu
+    hash_map_item_t** old_index = self->index;
+    uint8_t* old_ctrl = self->ctrl;
+    self->index = new_index;
+    self->ctrl = new_ctrl;
+    self->allocated = size;
+
+    // prekopirovani indexu, novy index neobsahuje dummy objekty
+    self->deleted = 0;
+    for (hash_map_item_t* item = self->first; item != NULL; item = item->next)
+    {
+        // zmenila se velikost, potrebujeme prepocitat indexy
+        hash_map_place(self, item);
+    }
+    // uvolneni stareho indexu, seznam obsahuje i polozky rozpracovane realokace
+    free(old_index);
+    free(old_ctrl);
+    hash_map_end_resize(self);
+
+    return OK;
+}
+
+/**
+ * @brief Odstraní místa s @c dummy objektem bez alokace nového indexu.
+ *
+ * Aktuální index se vyprázdní a všechny položky se do něj znovu vloží
+ * podle seznamu záznamů. Rozpracovaná realokace se nejprve dokončí.
+ *
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ */
+void hash_map_rehash_in_place(hash_map_t* self)
+{
+    hash_map_migrate(self, SIZE_MAX);
+
+    // vycisteni indexu, velikost se nemeni
+    for (size_t i = 0; i < self->allocated; ++i)
+    {
+        self->index[i] = NULL;
+    }
+    memset(self->ctrl, HASH_MAP_CTRL_EMPTY, self->allocated + HASH_MAP_GROUP_WIDTH);
+
+    // znovuvlozeni polozek, vycisteny index neobsahuje dummy objekty
+    self->deleted = 0;
+    for (hash_map_item_t* item = self->first; item != NULL; item = item->next)
+    {
+        hash_map_place(self, item);
+    }
+}
+
+/**
+ * @brief Vložení klíče se spočítaným hašem bez kontroly zaplnění indexu.
+ *
+ * Index musí mít volné místo, o realokaci se stará volající.
+ *
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče.
+ * @param[in] hash   Haš zadaného klíče.
+ * @param[in] value  Hodnota k uložení.
+ *
+ * @return @c KEY_ALREADY_EXISTS pokud se klíč nachází v tabulce,
+ *         @c MEMORY_ERROR v případě chyby alokace, jinak @c OK.
+ */
+hash_map_state_code_t hash_map_insert(hash_map_t* self, const char* key,
+                                      size_t length, size_t hash, int value)
+{
+    size_t idx = hash_map_lookup(self, key, length, hash);
+
+    // klic v tabulce neni, vlozime jej na prazdne misto nebo misto dummy objektu
+    if (idx == HASH_MAP_NOT_FOUND) 
+    {
+        hash_map_item_t* item = hash_map_item_alloc(self, key, length);
+        if (item == NULL)
+        {
+            // alokace pameti selhala
+            return MEMORY_ERROR;
+        }
+
+        item->hash = hash;
+        item->value = value;
+        item->next = NULL;
+        item->prev = NULL;
+        idx = hash_map_place(self, item);
+        self->used++;
+        // je seznam zaznamu prazdny?
+        if (self->last == NULL)
+        {
+            self->first = self->last = self->index[idx];
+        }
+        else
+        {
+            self->last->next = self->index[idx];
+            self->index[idx]->prev = self->last;
+            self->last = self->index[idx];
+        }
+        return OK;
+    }
+    else 
+    {
+        self->index[idx]->value = value;
+        return KEY_ALREADY_EXISTS;
+    }
+}
+
+/**
+ * @brief Inicializace hašovací tabulky.
+ * 
+ * Metoda alokuje a inicializuje položky struktury hašovací tabulky.
+ * 
+ * @param self[in] Ukazatel na neinicializovanou hašovací tabulku
+ * @param size[in] Počet prvků v tabulce.
+ * 
+ * @return @c MEMORY_ERROR v případě chyby v alokaci paměti, jinak @c OK.
+ */
+hash_map_state_code_t hash_map_init(hash_map_t* self, size_t size)
+{
+    self->dummy = (hash_map_item_t*)malloc(sizeof(hash_map_item_t));
+    self->first = self->last = NULL;
+    self->used = 0;
+    self->deleted = 0;
+    self->allocated = 0;
+    self->index = NULL;
+    self->ctrl = NULL;
+    self->hash_function = hash_map_wyhash;
+    self->seed = 0;
+    self->slab = NULL;
+    self->old_index = NULL;
+    self->old_ctrl = NULL;
+    self->old_allocated = 0;
+    self->migrated = 0;
+    self->resize_step = 0;
+    
+    if (hash_map_reserve(self, size) == MEMORY_ERROR)
+    {
+        free(self->dummy);
+        return MEMORY_ERROR;
+    }
+
+    return OK;
+}
+
+/*******************************************************************************
+ * Definice veřejných metod.
+ ******************************************************************************/
+
+hash_map_t* hash_map_ctor()
+{
+    hash_map_t* map = (hash_map_t*)malloc(sizeof(hash_map_t));
+    if (map != NULL && hash_map_init(map, HASH_MAP_INIT_SIZE) == MEMORY_ERROR) 
+    {
+        free(map);
+        map = NULL;
+    }
+    return map;
+}
+
+void hash_map_clear(hash_map_t* self)
+{
+    hash_map_item_t* item = self->first;
+    hash_map_item_t* curr_item;
+    // se slab alokatorem staci projit seznam jen kvuli samostatne alokovanym polozkam
+    bool walk = self->slab == NULL || self->slab->large_items > 0;
+    while (walk && item != NULL)
+    {
+        curr_item = item;
+        item = item->next;
+        if (self->slab == NULL || curr_item->key_len >= HASH_MAP_INLINE_KEY_SIZE)
+        {
+            free(curr_item);
+        }
+    }
+
+    if (self->slab != NULL)
+    {
+        // polozky s kratkym klicem uvolnime po celych blocich
+        hash_map_slab_release(self->slab);
+        self->slab->large_items = 0;
+    }
+
+    for (size_t i = 0; i < self->allocated; ++i)
+    {
+        self->index[i] = NULL;
+    }
+    memset(self->ctrl, HASH_MAP_CTRL_EMPTY, self->allocated + HASH_MAP_GROUP_WIDTH);
+    hash_map_end_resize(self);
+
+    self->first = NULL;
+    self->last = NULL;
+    self->used = 0;
+    self->deleted = 0;
+}
+
+void hash_map_dtor(hash_map_t* self)
+{
+    hash_map_clear(self);
+    free(self->index);
+    free(self->ctrl);
+    free(self->dummy);
+    free(self->slab);
+    self->index = NULL;
+    self->ctrl = NULL;
+    self->allocated = 0;
+    free(self);
+}
+
+hash_map_state_code_t hash_map_reserve(hash_map_t* self, size_t size)
+{
+    // chceme alokovat mene mista nez je vlozenych zaznamu?
+    if (size < self->used)
+    {
+        return VALUE_ERROR;
+    }
+
+    // velikost indexu zaokrouhlime na mocninu dvou
+    size_t capacity = 1;
+    while (capacity < size)
+    {
+        if (capacity > SIZE_MAX / (2 * sizeof(hash_map_item_t*)))
+        {
+            // takovy index nelze alokovat
+            return MEMORY_ERROR;
+        }
+        capacity <<= 1;
+    }
+
+    if (capacity == self->allocated)
+    {
+        // jiz je alokovano
+        return OK;
+    }
+
+    return hash_map_rebuild_index(self, capacity);
+}
+
+hash_map_state_code_t hash_map_set_hash_function(
+    hash_map_t* self, hash_map_hash_function_t hash_function, size_t seed)
+{
+    hash_map_hash_function_t old_function = self->hash_function;
+    size_t old_seed = self->seed;
+    self->hash_function = hash_function != NULL ? hash_function : hash_map_wyhash;
+    self->seed = seed;
+
+    // vlozene polozky je potreba znovu zahasovat a preindexovat
+    for (hash_map_item_t* item = self->first; item != NULL; item = item->next)
+    {
+        item->hash = self->hash_function(item->key, item->key_len, self->seed);
+    }
+
+    hash_map_state_code_t result = hash_map_rebuild_index(self, self->allocated);
+    if (result != OK)
+    {
+        // index zustal nezmeneny, obnovime puvodni funkci a hase polozek
+        self->hash_function = old_function;
+        self->seed = old_seed;
+        for (hash_map_item_t* item = self->first; item != NULL; item = item->next)
+        {
+            item->hash = self->hash_function(item->key, item->key_len, self->seed);
+        }
+    }
+
+    return result;
+}
+
+hash_map_state_code_t hash_map_enable_slab(hash_map_t* self, 
+                                           size_t items_per_chunk)
+{
+    // jiz vlozene polozky byly alokovany samostatne
+    if (self->first != NULL || items_per_chunk == 0)
+    {
+        return VALUE_ERROR;
+    }
+
+    // velikost bloku vcetne slotu s ukazatelem na dalsi blok nesmi pretect
+    if (items_per_chunk > SIZE_MAX / sizeof(hash_map_item_t) - 1)
+    {
+        return VALUE_ERROR;
+    }
+
+    if (self->slab == NULL)
+    {
+        self->slab = (hash_map_slab_t*)calloc(1, sizeof(hash_map_slab_t));
+        if (self->slab == NULL)
+        {
+            // alokace pameti selhala
+            return MEMORY_ERROR;
+        }
+    }
+    self->slab->items_per_chunk = items_per_chunk;
+
+    return OK;
+}
+
+void hash_map_set_incremental_resize(hash_map_t* self, size_t step)
+{
+    self->resize_step = step;
+    if (step == 0)
+    {
+        // rozpracovanou realokaci dokoncime
+        hash_map_migrate(self, SIZE_MAX);
+    }
+}
+
+hash_map_state_code_t hash_map_shrink_to_fit(hash_map_t* self)
+{
+    size_t size = HASH_MAP_INIT_SIZE;
+    while ((double)self->used >= (double)size * HASH_MAP_REALLOCATION_THRESHOLD)
+    {
+        size <<= 1;
+    }
+
+    if (size == self->allocated)
+    {
+        // pri stejne velikosti staci odstranit dummy objekty v miste
+        hash_map_rehash_in_place(self);
+        return OK;
+    }
+    return hash_map_rebuild_index(self, size);
+}
+
+size_t hash_map_size(hash_map_t* self) 
+{
+    return self->used;
+}
+
+size_t hash_map_capacity(hash_map_t* self)
+{
+    return self->allocated;
+}
+
+size_t hash_map_key_hash(hash_map_t* self, const char* key, size_t length)
+{
+    return hash_function(self, key, length);
+}
+
+bool hash_map_contains(hash_map_t* self, const char* key)
+{
+    return hash_map_contains_n(self, key, strlen(key));
+}
+
+bool hash_map_contains_n(hash_map_t* self, const char* key, size_t length)
+{
+    return hash_map_contains_hashed(self, key, length, hash_function(self, key, length));
+}
+
+bool hash_map_contains_hashed(hash_map_t* self, const char* key, size_t length,
+                              size_t hash)
+{
+    hash_map_migrate(self, self->resize_step);
+    return hash_map_lookup(self, key, length, hash) != HASH_MAP_NOT_FOUND;
+}
+
+hash_map_state_code_t hash_map_put(hash_map_t* self, const char* key, int value)
+{
+    return hash_map_put_n(self, key, strlen(key), value);
+}
+
+hash_map_state_code_t hash_map_put_n(hash_map_t* self, const char* key, 
+                                     size_t length, int value)
+{
+    return hash_map_put_hashed(self, key, length, hash_function(self, key, length), value);
+}
+
+hash_map_state_code_t hash_map_put_hashed(hash_map_t* self, const char* key, 
+                                          size_t length, size_t hash, int value)
+{
+    hash_map_migrate(self, self->resize_step);
+
+    // je potreba realokovat misto? dummy objekty prodluzuji hledani stejne jako zaznamy
+    if (((float)(self->used + self->deleted) / (float)self->allocated) >= HASH_MAP_REALLOCATION_THRESHOLD)
+    {
+        // prevazuji dummy objekty, staci reindexace v miste pri stejne velikosti
+        bool sweep = self->deleted >= self->used;
+        hash_map_state_code_t state = OK;
+        if (self->resize_step > 0)
+        {
+            // postupna realokace omezuje praci jedne operace i pri stejne velikosti
+            state = hash_map_start_resize(self, sweep ? self->allocated : self->allocated<<1);
+        }
+        else if (sweep)
+        {
+            hash_map_rehash_in_place(self);
+        }
+        else
+        {
+            state = hash_map_rebuild_index(self, self->allocated<<1);
+        }
+        if (state != OK &&
+            self->used >= self->allocated)
+        {
+            // v plnem indexu neni misto pro novou polozku
+            return MEMORY_ERROR;
+        }
+    }
+
+    return hash_map_insert(self, key, length, hash, value);
+}
+
+hash_map_state_code_t hash_map_put_many(hash_map_t* self, const char* const* keys,
+                                        const int* values, size_t n,
+                                        hash_map_state_code_t* statuses)
+{
+    // index zvetsime jednou tak, aby se do nej vesly vsechny klice davky
+    size_t size = self->allocated;
+    while (n > 0 && (double)(self->used + n) >= (double)size * HASH_MAP_REALLOCATION_THRESHOLD)
+    {
+        if (n > SIZE_MAX - self->used || size > SIZE_MAX / (2 * sizeof(hash_map_item_t*)))
+        {
+            // takovy index nelze alokovat
+            return MEMORY_ERROR;
+        }
+        size <<= 1;
+    }
+    if (size != self->allocated)
+    {
+        if (hash_map_rebuild_index(self, size) != OK)
+        {
+            // alokace pameti selhala
+            return MEMORY_ERROR;
+        }
+    }
+    else if ((double)(self->used + self->deleted + n) >= (double)size * HASH_MAP_REALLOCATION_THRESHOLD)
+    {
+        // dummy objekty by jinak zabiraly mista, odstranime je v miste
+        hash_map_rehash_in_place(self);
+    }
+
+    size_t lengths[HASH_MAP_BATCH_SIZE];
+    size_t hashes[HASH_MAP_BATCH_SIZE];
+
+    for (size_t start = 0; start < n; start += HASH_MAP_BATCH_SIZE)
+    {
+        size_t count = n - start < HASH_MAP_BATCH_SIZE ? n - start : HASH_MAP_BATCH_SIZE;
+        const char* const* batch = keys + start;
+        hash_map_migrate(self, self->resize_step);
+
+        // hase cele davky najednou, bez zavislosti na obsahu indexu
+        for (size_t i = 0; i < count; ++i)
+        {
+            lengths[i] = strlen(batch[i]);
+            hashes[i] = hash_function(self, batch[i], lengths[i]);
+            HASH_MAP_PREFETCH(self->ctrl + hash_map_h1(self, hashes[i]));
+        }
+
+        // vkladame v poradi klicu, aby seznam odpovidal poradi vlozeni
+        for (size_t i = 0; i < count; ++i)
+        {
+            hash_map_state_code_t state = hash_map_insert(self, batch[i], lengths[i],
+                                                          hashes[i], values[start + i]);
+            if (state == MEMORY_ERROR)
+            {
+                return MEMORY_ERROR;
+            }
+            if (statuses != NULL)
+            {
+                statuses[start + i] = state;
+            }
+        }
+    }
+
+    return OK;
+}
+
+hash_map_state_code_t hash_map_get(hash_map_t* self, const char* key, int* dst)
+{
+    return hash_map_get_n(self, key, strlen(key), dst);
+}
+
+hash_map_state_code_t hash_map_get_n(hash_map_t* self, const char* key, 
+                                     size_t length, int* dst)
+{
+    return hash_map_get_hashed(self, key, length, hash_function(self, key, length), dst);
+}
+
+hash_map_state_code_t hash_map_get_hashed(hash_map_t* self, const char* key, 
+                                          size_t length, size_t hash, int* dst)
+{
+    hash_map_migrate(self, self->resize_step);
+    size_t idx = hash_map_lookup(self, key, length, hash);
+
+    if (idx == HASH_MAP_NOT_FOUND)
+    {
+        // klic neni asociovan se zadnym zaznamem
+        return KEY_ERROR;
+    }
+    
+    *dst = self->index[idx]->value;
+
+    return OK;
+}
+
+const char* hash_map_stored_key_hashed(hash_map_t* self, const char* key, 
+                                       size_t length, size_t hash)
+{
+    hash_map_migrate(self, self->resize_step);
+    size_t idx = hash_map_lookup(self, key, length, hash);
+
+    return idx == HASH_MAP_NOT_FOUND ? NULL : self->index[idx]->key;
+}
+
+size_t hash_map_get_many(hash_map_t* self, const char* const* keys, size_t n,
+                         int* values, hash_map_state_code_t* statuses)
+{
+    size_t lengths[HASH_MAP_BATCH_SIZE];
+    size_t hashes[HASH_MAP_BATCH_SIZE];
+    size_t mask = self->allocated - 1;
+    size_t found = 0;
+
+    for (size_t start = 0; start < n; start += HASH_MAP_BATCH_SIZE)
+    {
+        size_t count = n - start < HASH_MAP_BATCH_SIZE ? n - start : HASH_MAP_BATCH_SIZE;
+        const char* const* batch = keys + start;
+        hash_map_migrate(self, self->resize_step);
+
+        // 1. hase cele davky a prednacteni ridicich bajtu a indexu
+        for (size_t i = 0; i < count; ++i)
+        {
+            lengths[i] = strlen(batch[i]);
+            hashes[i] = hash_function(self, batch[i], lengths[i]);
+            size_t pos = hash_map_h1(self, hashes[i]);
+            HASH_MAP_PREFETCH(self->ctrl + pos);
+            HASH_MAP_PREFETCH(self->index + pos);
+        }
+
+        // 2. prednacteni polozek, jejichz otisk odpovida klici
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t pos = hash_map_h1(self, hashes[i]);
+            unsigned match = hash_map_group_match(self->ctrl + pos, hash_map_h2(hashes[i]));
+            for (; match != 0; match &= match - 1)
+            {
+                HASH_MAP_PREFETCH(self->index[(pos + hash_map_ctz(match)) & mask]);
+            }
+        }
+
+        // 3. porovnani klicu, data uz by mela byt v cache
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t idx = hash_map_lookup(self, batch[i], lengths[i], hashes[i]);
+            if (idx == HASH_MAP_NOT_FOUND)
+            {
+                statuses[start + i] = KEY_ERROR;
+            }
+            else
+            {
+                values[start + i] = self->index[idx]->value;
+                statuses[start + i] = OK;
+                found++;
+            }
+        }
+    }
+
+    return found;
+}
+
+hash_map_state_code_t hash_map_remove(hash_map_t* self, const char* key)
+{
+    int dst;
+    return hash_map_pop(self, key, &dst);
+}
+
+hash_map_state_code_t hash_map_remove_n(hash_map_t* self, const char* key, 
+                                        size_t length)
+{
+    int dst;
+    return hash_map_pop_n(self, key, length, &dst);
+}
+
+hash_map_state_code_t hash_map_remove_hashed(hash_map_t* self, const char* key, 
+                                             size_t length, size_t hash)
+{
+    int dst;
+    return hash_map_pop_hashed(self, key, length, hash, &dst);
+}
+
+hash_map_state_code_t hash_map_pop(hash_map_t* self, const char* key, int* dst)
+{
+    return hash_map_pop_n(self, key, strlen(key), dst);
+}
+
+hash_map_state_code_t hash_map_pop_n(hash_map_t* self, const char* key, 
+                                     size_t length, int* dst)
+{
+    return hash_map_pop_hashed(self, key, length, hash_function(self, key, length), dst);
+}
+
+hash_map_state_code_t hash_map_pop_hashed(hash_map_t* self, const char* key, 
+                                          size_t length, size_t hash, int* dst)
+{
+    hash_map_migrate(self, self->resize_step);
+    size_t idx = hash_map_lookup(self, key, length, hash);
+
+    if (idx == HASH_MAP_NOT_FOUND)
+    {
+        // klic neni asociovan se zadnym zaznamem
+        return KEY_ERROR;
+    }
+    else 
+    {
+        // jedna se o prvni zaznam v seznamu?
+        if (self->index[idx]->prev == NULL)
+        {
+            self->first = self->index[idx]->next;
+        }
+        else 
+        {
+            self->index[idx]->prev->next = self->index[idx]->next;
+        }
+        // jedna se o posledni zaznam v seznamu?
+        if (self->index[idx]->next == NULL)
+        {
+            self->last = self->index[idx]->prev;
+        }
+        else 
+        {
+            self->index[idx]->next->prev = self->index[idx]->prev;
+        }
+        // uloz hodnotu
+        *dst = self->index[idx]->value;
+        // smaz zaznam
+        hash_map_item_free(self, self->index[idx]);
+        // Nahrazeni zaznamu za dummy objekt.
+        // V pripade kolize, odstraneni prvne vlozeneho zaznamu s kolizi,
+        // a nastaveni daneho mista na NULL, algoritmus by nemel informaci, 
+        // zda ke kolizi doslo.
+        self->index[idx] = self->dummy;
+        hash_map_set_ctrl(self, idx, HASH_MAP_CTRL_DELETED);
+        self->used--;
+        self->deleted++;
+    }
+
+    return OK;
+}
 
 /*******************************************************************************
- * Pomocné metody.
+ * Souběžná hašovací tabulka.
  ******************************************************************************/
 /**
- * @brief Výpočet haše pro zadaný řetězec.
+ * @brief Položka souběžné tabulky.
  *
- * @param[in] str klíč
- * @return hash 
+ * Klíč a haš se po vložení nemění, čtenáři je proto porovnávají bez zámku.
+ * Klíč je uložen hned za strukturou.
  */
-size_t hash_function(const char* str)
+typedef struct concurrent_hash_map_node
 {
-    size_t hash = 0;
+    std::atomic<struct concurrent_hash_map_node*> next; ///< Další položka koše
+    std::atomic<int> value;                 ///< Uložená hodnota
+    size_t hash;                            ///< Haš klíče
+    size_t key_len;                         ///< Délka klíče bez ukončovací nuly
+    struct concurrent_hash_map_node* retired; ///< Další položka čekající na uvolnění
+} concurrent_hash_map_node_t;
 
-    for (size_t idx = 0; str[idx] != '\0'; idx++)
-    {
-        hash += HASH_FUNCTION_PARAM_A*str[idx] + HASH_FUNCTION_PARAM_B;
-    }
+/**
+ * @brief Index souběžné tabulky, pole košů s řetězci položek.
+ */
+typedef struct concurrent_hash_map_table
+{
+    size_t mask;                                    ///< Počet košů - 1
+    std::atomic<concurrent_hash_map_node_t*>* buckets; ///< Koše indexu
+    struct concurrent_hash_map_table* retired;      ///< Další index čekající na uvolnění
+} concurrent_hash_map_table_t;
 
-    return hash;
-}
+/** Zámek zapisovatelů zarovnaný na vlastní řádek cache. */
+struct alignas(64) concurrent_hash_map_stripe
+{
+    std::mutex lock;
+};
+
+/** Počítadla čtenářů sudé a liché epochy zarovnaná na vlastní řádek cache. */
+struct alignas(64) concurrent_hash_map_readers
+{
+    std::atomic<size_t> active[2];
+};
+
+struct concurrent_hash_map
+{
+    /** Aktuální index, mění se jen při realokaci se všemi zámky. */
+    alignas(64) std::atomic<concurrent_hash_map_table_t*> table;
+    std::atomic<uint64_t> epoch;            ///< Epocha čtenářů
+    alignas(64) std::atomic<size_t> used;   ///< Počet vložených položek
+    concurrent_hash_map_stripe stripes[CONCURRENT_HASH_MAP_STRIPES];
+    concurrent_hash_map_readers readers[CONCURRENT_HASH_MAP_READER_SLOTS];
+    std::mutex reclaim_lock;                ///< Chrání seznamy ke uvolnění
+    concurrent_hash_map_node_t* retired_nodes;   ///< Odstraněné položky
+    size_t retired_count;                        ///< Počet odstraněných položek
+    concurrent_hash_map_table_t* retired_tables; ///< Nahrazené indexy
+};
 
 /**
- * @brief Výpočet indexu v hašovací tabulce v závislosti na dvojici klíč-hash.
- * 
- * V případě kolize funkce nalezne další volný index v tabulce. V případě 
- * vyhledávání považujeme @c dummy objekt jako jakýkoliv jiný záznam, tedy
- * @p ignore_dummy je nastaveno na @c false . Při vkládání je @c dummy objekt 
- * ekvivalentní prázdnému místu, tedy @p ignore_dummy je nastaveno na @c true .
- * Tento jev je způsoben kvůli kolizím klíčů. Když je záznam odstraněn, je 
- * nahrazen za @c dummy objekt, aby bylo možné vyřešit případné kolize.
- *
- * @param[in] self         Ukazatel na strukturu hašovací tabulky.
- * @param[in] str          Klíč.
- * @param[in] str          Haš zadaného klíče.
- * @param[in] ignore_dummy Pokud @c true, @c dummy objekt je vždy přeskočen,
- *                         pokud @c false, @c dummy objekt je interpretován jako
- *                         @c NULL.
- * 
- * @return Index záznamu asociovaný k zadanému klíči a haši, nebo prázdné místo
- *         v tabulce.
+ * @brief Klíč položky souběžné tabulky.
  */
-size_t hash_map_lookup_handle(hash_map_t* self, const char* key, size_t hash, 
-                              bool ignore_dummy)
+static inline char* concurrent_hash_map_node_key(concurrent_hash_map_node_t* node)
 {
-    size_t idx = hash % self->allocated;
-    size_t perturb = hash;
+    return (char*)(node + 1);
+}
 
-    while ( 
-        (self->index[idx] != NULL && 
-        (ignore_dummy || self->index[idx] != self->dummy)) &&
-        (
-            self->index[idx] == self->dummy ||
-            (
-                (self->index[idx]->hash != hash) || 
-                (strcmp(self->index[idx]->key, key) != 0)
-            )
-        )
-    )
+/**
+ * @brief Alokace položky souběžné tabulky i s klíčem.
+ *
+ * @return Položka s nastaveným klíčem, v případě chyby alokace @c NULL .
+ */
+concurrent_hash_map_node_t* concurrent_hash_map_node_alloc(const char* key, 
+                                                           size_t length, 
+                                                           size_t hash, 
+                                                           int value)
+{
+    void* memory = malloc(sizeof(concurrent_hash_map_node_t) + length + 1);
+    if (memory == NULL)
     {
-        idx = ((idx << 2) + idx + perturb + 1) % self->allocated;
-        perturb >>= HASH_MAP_PERTURB_SHIFT;
+        return NULL;
     }
 
-    return idx;
+    concurrent_hash_map_node_t* node = new (memory) concurrent_hash_map_node_t;
+    node->next.store(NULL, std::memory_order_relaxed);
+    node->value.store(value, std::memory_order_relaxed);
+    node->hash = hash;
+    node->key_len = length;
+    node->retired = NULL;
+    memcpy(concurrent_hash_map_node_key(node), key, length + 1);
+
+    return node;
 }
+
 /**
- * @brief Výpočet indexu v hašovací tabulce v závislosti na dvojici klíč-hash.
+ * @brief Alokace prázdného indexu souběžné tabulky.
  *
- * @param[in] self Ukazatel na strukturu hašovací tabulky.
- * @param[in] str  Klíč.
- * @param[in] str  Haš zadaného klíče.
- * 
- * @return Index záznamu asociovaný k zadanému klíči a haši, nebo prázdné místo
- *         v tabulce.
- * 
- * @see hash_map_lookup_handle
+ * @param[in] size Počet košů, mocnina dvou.
+ *
+ * @return Index, v případě chyby alokace @c NULL .
  */
-size_t hash_map_lookup(hash_map_t* self, const char* key, size_t hash)
+concurrent_hash_map_table_t* concurrent_hash_map_table_alloc(size_t size)
 {
-    return hash_map_lookup_handle(self, key, hash, true);
+    concurrent_hash_map_table_t* table = 
+        (concurrent_hash_map_table_t*)malloc(sizeof(concurrent_hash_map_table_t));
+    std::atomic<concurrent_hash_map_node_t*>* buckets = 
+        new (std::nothrow) std::atomic<concurrent_hash_map_node_t*>[size];
+    if (table == NULL || buckets == NULL)
+    {
+        // alokace pameti selhala
+        free(table);
+        delete[] buckets;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        buckets[i].store(NULL, std::memory_order_relaxed);
+    }
+    table->mask = size - 1;
+    table->buckets = buckets;
+    table->retired = NULL;
+
+    return table;
 }
 
 /**
- * @brief Inicializace hašovací tabulky.
- * 
- * Metoda alokuje a inicializuje položky struktury hašovací tabulky.
- * 
- * @param self[in] Ukazatel na neinicializovanou hašovací tabulku
- * @param size[in] Počet prvků v tabulce.
- * 
- * @return @c MEMORY_ERROR v případě chyby v alokaci paměti, jinak @c OK.
+ * @brief Uvolnění indexu souběžné tabulky i s položkami v jeho koších.
+ *
+ * @param[in] table Index.
  */
-hash_map_state_code_t hash_map_init(hash_map_t* self, size_t size)
+void concurrent_hash_map_table_free(concurrent_hash_map_table_t* table)
 {
-    self->dummy = (hash_map_item_t*)malloc(sizeof(hash_map_item_t));
-    self->first = self->last = NULL;
-    self->used = 0;
-    self->allocated = 0;
-    self->index = NULL;
-    
-    if (hash_map_reserve(self, size) == MEMORY_ERROR)
+    for (size_t i = 0; i <= table->mask; ++i)
     {
-        free(self->dummy);
-        return MEMORY_ERROR;
+        concurrent_hash_map_node_t* node = table->buckets[i].load(std::memory_order_relaxed);
+        while (node != NULL)
+        {
+            concurrent_hash_map_node_t* next = node->next.load(std::memory_order_relaxed);
+            free(node);
+            node = next;
+        }
     }
-
-    return OK;
+    delete[] table->buckets;
+    free(table);
 }
 
-/*******************************************************************************
- * Definice veřejných metod.
- ******************************************************************************/
+/**
+ * @brief Počítadla čtenářů příslušná volajícímu vláknu.
+ *
+ * Vlákna dostávají čísla postupně, takže do
+ * @c CONCURRENT_HASH_MAP_READER_SLOTS vláken má každé vlastní počítadla.
+ */
+static inline concurrent_hash_map_readers* concurrent_hash_map_reader_slot(
+    concurrent_hash_map_t* self)
+{
+    static std::atomic<size_t> next_thread(0);
+    static thread_local size_t thread_slot = 
+        next_thread.fetch_add(1, std::memory_order_relaxed) % CONCURRENT_HASH_MAP_READER_SLOTS;
+    return &self->readers[thread_slot];
+}
 
-hash_map_t* hash_map_ctor()
+/**
+ * @brief Přihlášení čtenáře do aktuální epochy.
+ *
+ * Pokud se epocha mezi čtením a přihlášením změnila, čtenář se přihlásí
+ * znovu, jinak by jej zapisovatel čekající na starou epochu nemusel vidět.
+ *
+ * @return Parita epochy, ze které se čtenář musí odhlásit.
+ */
+static inline unsigned concurrent_hash_map_pin(concurrent_hash_map_readers* slot,
+                                               concurrent_hash_map_t* self)
 {
-    hash_map_t* map = (hash_map_t*)malloc(sizeof(hash_map_t));
-    if (map != NULL && hash_map_init(map, HASH_MAP_INIT_SIZE) == MEMORY_ERROR) 
+    for (;;)
     {
-        free(map);
-        map = NULL;
+        uint64_t epoch = self->epoch.load(std::memory_order_seq_cst);
+        unsigned parity = (unsigned)(epoch & 1);
+        slot->active[parity].fetch_add(1, std::memory_order_seq_cst);
+        if (self->epoch.load(std::memory_order_seq_cst) == epoch)
+        {
+            return parity;
+        }
+        slot->active[parity].fetch_sub(1, std::memory_order_release);
     }
-    return map;
 }
 
-void hash_map_clear(hash_map_t* self)
+/**
+ * @brief Odhlášení čtenáře z epochy.
+ */
+static inline void concurrent_hash_map_unpin(concurrent_hash_map_readers* slot,
+                                             unsigned parity)
 {
-    size_t idx;
-    hash_map_item_t* item = self->first;
-    hash_map_item_t* curr_item;
-    while (item != NULL)
+    slot->active[parity].fetch_sub(1, std::memory_order_release);
+}
+
+/**
+ * @brief Uvolnění odstraněných položek a indexů, které už žádný čtenář nevidí.
+ *
+ * Posune epochu a počká, až se odhlásí všichni čtenáři přihlášení v 
+ * předchozí epoše. Noví čtenáři už odpojené položky nenajdou. Volající 
+ * drží @c reclaim_lock .
+ *
+ * @param[in] self Ukazatel na tabulku.
+ */
+void concurrent_hash_map_reclaim(concurrent_hash_map_t* self)
+{
+    concurrent_hash_map_node_t* nodes = self->retired_nodes;
+    concurrent_hash_map_table_t* tables = self->retired_tables;
+    self->retired_nodes = NULL;
+    self->retired_tables = NULL;
+    self->retired_count = 0;
+
+    unsigned parity = (unsigned)(self->epoch.fetch_add(1, std::memory_order_seq_cst) & 1);
+    for (size_t i = 0; i < CONCURRENT_HASH_MAP_READER_SLOTS; ++i)
     {
-        curr_item = item;
-        item = item->next;
-        free(curr_item->key);
-        free(curr_item);
+        while (self->readers[i].active[parity].load(std::memory_order_seq_cst) != 0)
+        {
+            std::this_thread::yield();
+        }
     }
 
-    for (size_t i = 0; i < self->allocated; ++i)
+    while (nodes != NULL)
     {
-        self->index[i] = NULL;
+        concurrent_hash_map_node_t* next = nodes->retired;
+        free(nodes);
+        nodes = next;
+    }
+    while (tables != NULL)
+    {
+        concurrent_hash_map_table_t* next = tables->retired;
+        concurrent_hash_map_table_free(tables);
+        tables = next;
     }
-    
-
-    self->first = NULL;
-    self->last = NULL;
-    self->used = 0;
 }
 
-void hash_map_dtor(hash_map_t* self)
+/**
+ * @brief Vyhledání položky v koši bez zámku.
+ *
+ * @return Položka se zadaným klíčem nebo @c NULL .
+ */
+static concurrent_hash_map_node_t* concurrent_hash_map_find(
+    concurrent_hash_map_table_t* table, const char* key, size_t length, size_t hash)
 {
-    hash_map_clear(self);
-    free(self->index);
-    free(self->dummy);
-    self->index = NULL;
-    self->allocated = 0;
-    free(self);
+    concurrent_hash_map_node_t* node = 
+        table->buckets[hash & table->mask].load(std::memory_order_acquire);
+    for (; node != NULL; node = node->next.load(std::memory_order_acquire))
+    {
+        if (node->hash == hash && node->key_len == length &&
+            memcmp(concurrent_hash_map_node_key(node), key, length) == 0)
+        {
+            return node;
+        }
+    }
+    return NULL;
 }
 
-hash_map_state_code_t hash_map_reserve(hash_map_t* self, size_t size)
+/**
+ * @brief Zdvojnásobení indexu souběžné tabulky.
+ *
+ * Zamkne všechny zámky zapisovatelů a položky zkopíruje do nového indexu,
+ * protože čtenáři mohou stále procházet řetězce původního indexu. Původní
+ * index se uvolní až po odhlášení čtenářů. Pokud se alokace nezdaří,
+ * tabulka pracuje dál s původním indexem.
+ *
+ * @param[in] self Ukazatel na tabulku.
+ */
+void concurrent_hash_map_grow(concurrent_hash_map_t* self)
 {
-    // chceme alokovat mene mista nez je vlozenych zaznamu?
-    if (size < self->used)
+    for (size_t i = 0; i < CONCURRENT_HASH_MAP_STRIPES; ++i)
     {
-        return VALUE_ERROR;
+        self->stripes[i].lock.lock();
     }
 
-    if (size == self->allocated)
+    concurrent_hash_map_table_t* old_table = self->table.load(std::memory_order_relaxed);
+    concurrent_hash_map_table_t* new_table = NULL;
+    // jine vlakno mohlo index zvetsit mezitim
+    if (self->used.load(std::memory_order_relaxed) > old_table->mask + 1)
     {
-        // jiz je alokovano
-        return OK;
+        new_table = concurrent_hash_map_table_alloc((old_table->mask + 1) << 1);
     }
 
-    hash_map_item_t** new_index = (hash_map_item_t**)malloc(size*sizeof(hash_map_t*));
-    if (new_index == NULL)
+    for (size_t i = 0; new_table != NULL && i <= old_table->mask; ++i)
     {
-        // alokace pameti selhala
-        return MEMORY_ERROR;
+        concurrent_hash_map_node_t* node = old_table->buckets[i].load(std::memory_order_relaxed);
+        for (; node != NULL; node = node->next.load(std::memory_order_relaxed))
+        {
+            concurrent_hash_map_node_t* copy = concurrent_hash_map_node_alloc(
+                concurrent_hash_map_node_key(node), node->key_len, node->hash, 
+                node->value.load(std::memory_order_relaxed));
+            if (copy == NULL)
+            {
+                // alokace pameti selhala, zustaneme u puvodniho indexu
+                concurrent_hash_map_table_free(new_table);
+                new_table = NULL;
+                break;
+            }
+            std::atomic<concurrent_hash_map_node_t*>* bucket = 
+                &new_table->buckets[node->hash & new_table->mask];
+            copy->next.store(bucket->load(std::memory_order_relaxed), std::memory_order_relaxed);
+            bucket->store(copy, std::memory_order_relaxed);
+        }
     }
-    // vycisteni indexu
-    for (size_t i = 0; i < size; ++i)
+
+    if (new_table != NULL)
     {
-        new_index[i] = NULL;
+        self->table.store(new_table, std::memory_order_release);
     }
 
-    if (self->index != NULL)
+    for (size_t i = CONCURRENT_HASH_MAP_STRIPES; i > 0; --i)
     {
-        // prekopirovani indexu
-        size_t idx;
-        for (hash_map_item_t* item = self->first; item != NULL; item = item->next)
-        {
-            // zmenila se velikost, potrebujeme prepocitat indexy
-            idx = hash_map_lookup(self, item->key, item->hash);
-            new_index[idx] = item;
-        }
-        // uvolneni stareho indexu
-        free(self->index);
+        self->stripes[i - 1].lock.unlock();
     }
-    // nahrazeni stareho indexu
-    self->index = new_index;
-    self->allocated = size;
 
-    return OK; 
+    if (new_table != NULL)
+    {
+        std::lock_guard<std::mutex> guard(self->reclaim_lock);
+        old_table->retired = self->retired_tables;
+        self->retired_tables = old_table;
+        concurrent_hash_map_reclaim(self);
+    }
 }
 
-size_t hash_map_size(hash_map_t* self) 
+concurrent_hash_map_t* concurrent_hash_map_ctor()
 {
-    return self->used;
+    concurrent_hash_map_t* map = new (std::nothrow) concurrent_hash_map_t;
+    if (map == NULL)
+    {
+        return NULL;
+    }
+
+    // kos urcuji nejnizsi bity hase, index ma alespon tolik kosu jako zamku
+    concurrent_hash_map_table_t* table = 
+        concurrent_hash_map_table_alloc(CONCURRENT_HASH_MAP_STRIPES);
+    if (table == NULL)
+    {
+        delete map;
+        return NULL;
+    }
+
+    map->table.store(table, std::memory_order_relaxed);
+    map->epoch.store(0, std::memory_order_relaxed);
+    map->used.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < CONCURRENT_HASH_MAP_READER_SLOTS; ++i)
+    {
+        map->readers[i].active[0].store(0, std::memory_order_relaxed);
+        map->readers[i].active[1].store(0, std::memory_order_relaxed);
+    }
+    map->retired_nodes = NULL;
+    map->retired_count = 0;
+    map->retired_tables = NULL;
+
+    return map;
 }
 
-size_t hash_map_capacity(hash_map_t* self)
+void concurrent_hash_map_dtor(concurrent_hash_map_t* self)
 {
-    return self->allocated;
+    concurrent_hash_map_reclaim(self);
+    concurrent_hash_map_table_free(self->table.load(std::memory_order_relaxed));
+    delete self;
 }
 
-bool hash_map_contains(hash_map_t* self, const char* key)
+size_t concurrent_hash_map_size(concurrent_hash_map_t* self)
 {
-    size_t hash = hash_function(key); 
-    size_t idx = hash_map_lookup(self, key, hash);
-    return self->index[idx] != NULL;
+    return self->used.load(std::memory_order_relaxed);
 }
 
-hash_map_state_code_t hash_map_put(hash_map_t* self, const char* key, int value)
+hash_map_state_code_t concurrent_hash_map_put(concurrent_hash_map_t* self, 
+                                              const char* key, int value)
 {
-    // je potreba realokovat misto?
-    if (((float)self->used / (float)self->allocated) >= HASH_MAP_REALLOCATION_THRESHOLD)
-    {
-        hash_map_reserve(self, self->allocated<<1);
-    }
+    size_t length = strlen(key);
+    size_t hash = hash_map_wyhash(key, length, 0);
+    std::mutex& lock = self->stripes[hash & (CONCURRENT_HASH_MAP_STRIPES - 1)].lock;
+    bool grow;
 
-    size_t hash = hash_function(key);
-    size_t idx = hash_map_lookup_handle(self, key, hash, false);
-
-    // prazdne misto v indexu nebo se jedna o dummy objekt
-    // Vizte hash_map_lookup_handle
-    if (self->index[idx] == NULL || self->index[idx] == self->dummy) 
     {
-        self->index[idx] = (hash_map_item_t*)malloc(sizeof(hash_map_item_t));
-        if (self->index[idx] == NULL)
+        std::lock_guard<std::mutex> guard(lock);
+        // index se pod zamkem nemeni, realokace drzi vsechny zamky
+        concurrent_hash_map_table_t* table = self->table.load(std::memory_order_relaxed);
+        concurrent_hash_map_node_t* node = concurrent_hash_map_find(table, key, length, hash);
+        if (node != NULL)
         {
-            // alokace pameti selhala
-            return MEMORY_ERROR;
+            node->value.store(value, std::memory_order_relaxed);
+            return KEY_ALREADY_EXISTS;
         }
 
-        self->index[idx]->key = (char*)malloc((strlen(key)+1)*sizeof(char));
-        if (self->index[idx]->key == NULL)
+        node = concurrent_hash_map_node_alloc(key, length, hash, value);
+        if (node == NULL)
         {
             // alokace pameti selhala
-            free(self->index[idx]);
-            self->index[idx] = NULL;
             return MEMORY_ERROR;
         }
-        strcpy(self->index[idx]->key, key);
-        self->index[idx]->hash = hash;
-        self->index[idx]->value = value;
-        self->index[idx]->next = NULL;
-        self->index[idx]->prev = NULL;
-        self->used++;
-        // je seznam zaznamu prazdny?
-        if (self->last == NULL)
-        {
-            self->first = self->last = self->index[idx];
-        }
-        else
-        {
-            self->last->next = self->index[idx];
-            self->index[idx]->prev = self->last;
-            self->last = self->index[idx];
-        }
-        return OK;
+        std::atomic<concurrent_hash_map_node_t*>* bucket = &table->buckets[hash & table->mask];
+        node->next.store(bucket->load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // polozka je kompletni drive, nez ji ctenari uvidi
+        bucket->store(node, std::memory_order_release);
+
+        // prumerna delka retezce presahla jednu polozku
+        grow = self->used.fetch_add(1, std::memory_order_relaxed) + 1 > table->mask + 1;
     }
-    else 
+
+    if (grow)
     {
-        self->index[idx]->value = value;
-        return KEY_ALREADY_EXISTS;
+        concurrent_hash_map_grow(self);
     }
+
+    return OK;
 }
 
-hash_map_state_code_t hash_map_get(hash_map_t* self, const char* key, int* dst)
+hash_map_state_code_t concurrent_hash_map_get(concurrent_hash_map_t* self, 
+                                              const char* key, int* value)
 {
-    size_t hash = hash_function(key);
-    size_t idx = hash_map_lookup(self, key, hash);
+    size_t length = strlen(key);
+    size_t hash = hash_map_wyhash(key, length, 0);
+    concurrent_hash_map_readers* slot = concurrent_hash_map_reader_slot(self);
+    unsigned parity = concurrent_hash_map_pin(slot, self);
 
-    if (self->index[idx] == NULL)
+    concurrent_hash_map_node_t* node = concurrent_hash_map_find(
+        self->table.load(std::memory_order_acquire), key, length, hash);
+    if (node != NULL)
     {
-        // klic neni asociovan se zadnym zaznamem
-        return KEY_ERROR;
+        *value = node->value.load(std::memory_order_relaxed);
     }
-    
-    *dst = self->index[idx]->value;
 
-    return OK;
+    concurrent_hash_map_unpin(slot, parity);
+    return node != NULL ? OK : KEY_ERROR;
 }
 
-hash_map_state_code_t hash_map_remove(hash_map_t* self, const char* key)
+bool concurrent_hash_map_contains(concurrent_hash_map_t* self, const char* key)
 {
-    int dst;
-    return hash_map_pop(self, key, &dst);
+    int value;
+    return concurrent_hash_map_get(self, key, &value) == OK;
 }
 
-hash_map_state_code_t hash_map_pop(hash_map_t* self, const char* key, int* dst)
+hash_map_state_code_t concurrent_hash_map_pop(concurrent_hash_map_t* self, 
+                                              const char* key, int* value)
 {
-    size_t hash = hash_function(key);
-    size_t idx = hash_map_lookup(self, key, hash);
+    size_t length = strlen(key);
+    size_t hash = hash_map_wyhash(key, length, 0);
+    std::mutex& lock = self->stripes[hash & (CONCURRENT_HASH_MAP_STRIPES - 1)].lock;
+    concurrent_hash_map_node_t* node = NULL;
 
-    if (self->index[idx] == NULL)
-    {
-        // klic neni asociovan se zadnym zaznamem
-        return KEY_ERROR;
-    }
-    else 
     {
-        // jedna se o prvni zaznam v seznamu?
-        if (self->index[idx]->prev == NULL)
-        {
-            self->first = self->index[idx]->next;
-        }
-        else 
-        {
-            self->index[idx]->prev->next = self->index[idx]->next;
-        }
-        // jedna se o posledni zaznam v seznamu?
-        if (self->index[idx]->next == NULL)
+        std::lock_guard<std::mutex> guard(lock);
+        concurrent_hash_map_table_t* table = self->table.load(std::memory_order_relaxed);
+        std::atomic<concurrent_hash_map_node_t*>* link = &table->buckets[hash & table->mask];
+        for (node = link->load(std::memory_order_relaxed); node != NULL; 
+             node = link->load(std::memory_order_relaxed))
         {
-            self->last = self->index[idx]->prev;
+            if (node->hash == hash && node->key_len == length &&
+                memcmp(concurrent_hash_map_node_key(node), key, length) == 0)
+            {
+                break;
+            }
+            link = &node->next;
         }
-        else 
+
+        if (node == NULL)
         {
-            self->index[idx]->next->prev = self->index[idx]->prev;
+            // klic neni asociovan se zadnym zaznamem
+            return KEY_ERROR;
         }
-        // uloz hodnotu
-        *dst = self->index[idx]->value;
-        // smaz zaznam
-        free(self->index[idx]->key);
-        free(self->index[idx]);
-        // Nahrazeni zaznamu za dummy objekt.
-        // V pripade kolize, odstraneni prvne vlozeneho zaznamu s kolizi,
-        // a nastaveni daneho mista na NULL, algoritmus by nemel informaci, 
-        // zda ke kolizi doslo.
-        self->index[idx] = self->dummy;
+        *value = node->value.load(std::memory_order_relaxed);
+        // ukazatel next odpojene polozky zustava, ctenar na ni muze stale stat
+        link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+    self->used.fetch_sub(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(self->reclaim_lock);
+    node->retired = self->retired_nodes;
+    self->retired_nodes = node;
+    if (++self->retired_count >= CONCURRENT_HASH_MAP_RETIRE_BATCH)
+    {
+        concurrent_hash_map_reclaim(self);
     }
 
     return OK;
 }
 
+hash_map_state_code_t concurrent_hash_map_remove(concurrent_hash_map_t* self, 
+                                                 const char* key)
+{
+    int value;
+    return concurrent_hash_map_pop(self, key, &value);
+}
+
 /*** Konec souboru white_box_code.cpp ***/
@@ -26,17 +26,32 @@
 #include <string.h>     
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
+/** Velikost bufferu pro klíč uvnitř položky, kratší klíče se vejdou celé. */
+#define HASH_MAP_INLINE_KEY_SIZE 16
+/** Počet klíčů zpracovávaných najednou v dávkových operacích. */
+#define HASH_MAP_BATCH_SIZE 16
 /** Inicializační velikost tabulky. */
 #define HASH_MAP_INIT_SIZE 8                    
-/** Parametr použit v hledání dalšího indexu při kolizi. */
-#define HASH_MAP_PERTURB_SHIFT 5                
+/** Počet řídicích bajtů porovnávaných najednou při hledání v indexu. */
+#define HASH_MAP_GROUP_WIDTH 16
+/** Řídicí bajt prázdného místa v indexu. */
+#define HASH_MAP_CTRL_EMPTY 0x80
+/** Řídicí bajt místa s odstraněnou položkou (@c dummy ). */
+#define HASH_MAP_CTRL_DELETED 0xFE
 /** Mez zaplnění kdy se má realokovat velikost tabulky. */
 #define HASH_MAP_REALLOCATION_THRESHOLD 3/5.
-/** Hyperparametr v hašovácí funkci. */
+/** Hyperparametr v aditivní hašovácí funkci. */
 #define HASH_FUNCTION_PARAM_A 1794967309        
-/** Hyperparametr v hašovácí funkci. */
+/** Hyperparametr v aditivní hašovácí funkci. */
 #define HASH_FUNCTION_PARAM_B 7                 
+/** Počet zámků zapisovatelů souběžné tabulky (mocnina dvou). */
+#define CONCURRENT_HASH_MAP_STRIPES 64
+/** Počet počítadel čtenářů souběžné tabulky. */
+#define CONCURRENT_HASH_MAP_READER_SLOTS 64
+/** Počet odstraněných položek, po kterém se čeká na čtenáře a uvolní se. */
+#define CONCURRENT_HASH_MAP_RETIRE_BATCH 64
 
 // Informace pro C++ překladač, aby použil "C" linker pro následující funkce.
 extern "C" {
@@ -60,6 +75,15 @@ typedef enum {
     KEY_ALREADY_EXISTS      ///< Klíč již v hašovací tabulce existuje.
 } hash_map_state_code_t;
 
+/**
+ * @brief Hašovací funkce tabulky.
+ *
+ * Funkce dostane klíč, jeho délku bez ukončovací nuly a semínko tabulky.
+ * Pro stejný klíč a semínko musí vracet vždy stejnou hodnotu.
+ */
+typedef size_t (*hash_map_hash_function_t)(const char* key, size_t length,
+                                           size_t seed);
+
 /**
  * @brief Záznam v hašovací tabulce.
  * 
@@ -69,22 +93,64 @@ typedef enum {
  * pouze ukazatele do tohoto seznamu. Pořadí položek v seznamu odpovídá pořadí 
  * vložení daného klíče do tabulky. 
  * 
+ * Položka i s klíčem leží v jediném bloku paměti. Klíč je uložen od pole
+ * @c inline_key , klíče kratší než @c HASH_MAP_INLINE_KEY_SIZE se vejdou do
+ * samotné struktury, delší pokračují za jejím koncem. Blok delšího klíče má
+ * velikost @c offsetof(hash_map_item_t, inline_key) + délka klíče + 1 a klíč
+ * se zapisuje i čte přes ukazatel @c key spočítaný z adresy bloku, nikdy
+ * indexací pole @c inline_key za jeho deklarovanou mez.
+ * 
  * Uživatel by k položkám struktury neměl přistupovat přímo, ale pomocí 
  * definovaného rozhraní níže. Nicméně v rámci testování můžete přímo testovat, 
  * zda rozhraní pracuje s tímto datovým typem korektně.
  */
 typedef struct hash_map_item
 {
-    char* key;                  ///< Klíč
+    char* key;                  ///< Klíč, ukazuje na @c inline_key
+    size_t key_len;             ///< Délka klíče bez ukončovací nuly
     size_t hash;                ///< Hash
     int value;                  ///< Uložená hodnota
     struct hash_map_item* next; ///< Následující položka 
     struct hash_map_item* prev; ///< Předcházející položka
+    /** Začátek klíče, delší klíče přesahují za konec struktury. */
+    char inline_key[HASH_MAP_INLINE_KEY_SIZE];
 } hash_map_item_t;
 
+/**
+ * @brief Slab alokátor položek hašovací tabulky.
+ * 
+ * Položky s klíčem kratším než @c HASH_MAP_INLINE_KEY_SIZE mají stejnou
+ * velikost a přidělují se z velkých bloků paměti. Uvolněné položky se
+ * řetězí přes ukazatel @c next do seznamu volných položek a znovu se
+ * použijí. Položky s delším klíčem se alokují samostatně.
+ */
+typedef struct hash_map_slab
+{
+    void* chunks;                   ///< Seznam bloků, první slot bloku ukazuje na další blok
+    hash_map_item_t* free_list;     ///< Seznam uvolněných položek
+    hash_map_item_t* bump;          ///< Další nepoužitý slot aktuálního bloku
+    size_t remaining;               ///< Počet nepoužitých slotů aktuálního bloku
+    size_t items_per_chunk;         ///< Počet položek v jednom bloku
+    size_t large_items;             ///< Počet samostatně alokovaných položek
+} hash_map_slab_t;
+
 /**
  * @brief Datový typ hašovací tabulky. 
  * 
+ * Vedle indexu ukazatelů je udržováno pole řídicích bajtů stejné velikosti.
+ * Obsazené místo má v řídicím bajtu dolních 7 bitů haše položky, prázdné
+ * místo hodnotu @c HASH_MAP_CTRL_EMPTY a místo s odstraněnou položkou
+ * hodnotu @c HASH_MAP_CTRL_DELETED . Hledání porovnává řídicí bajty po
+ * skupinách @c HASH_MAP_GROUP_WIDTH míst a položku čte jen při shodě
+ * 7bitového otisku haše. Za polem je zopakováno prvních
+ * @c HASH_MAP_GROUP_WIDTH řídicích bajtů, aby skupina začínající kdekoliv
+ * v indexu ležela v souvislé paměti. Velikost indexu je vždy mocnina dvou.
+ * 
+ * Při postupné realokaci existuje vedle nového indexu ještě původní index.
+ * Položka leží vždy právě v jednom z nich a každá operace převede do nového
+ * indexu nejvýše @c resize_step míst původního indexu. Nalezená položka
+ * z původního indexu se převede hned.
+ * 
  * Uživatel by k položkám struktury neměl přistupovat přímo, ale pomocí 
  * definovaného rozhraní níže. Nicméně v rámci testování můžete přímo testovat, 
  * zda rozhraní pracuje s tímto datovým typem korektně.
@@ -92,12 +158,22 @@ typedef struct hash_map_item
 typedef struct hash_map
 {
     hash_map_item_t** index;    ///< Index hašovací tabulky
+    uint8_t* ctrl;              ///< Řídicí bajty indexu
     hash_map_item_t* first;     ///< První položka v seznamu
     hash_map_item_t* last;      ///< Poslední položka v seznamu
     /** Při odstranění je položka v indexu nahrazena tímto ukazatelem. */
     hash_map_item_t* dummy;     
     size_t allocated;           ///< Alokované místo (velikost indexu)
     size_t used;                ///< Počet vložených položek (velikost seznamu)
+    size_t deleted;             ///< Počet míst s @c dummy objektem v indexu
+    hash_map_hash_function_t hash_function; ///< Hašovací funkce klíčů
+    size_t seed;                ///< Semínko hašovací funkce
+    hash_map_slab_t* slab;      ///< Slab alokátor položek, @c NULL pokud je vypnutý
+    hash_map_item_t** old_index;///< Původní index během postupné realokace, jinak @c NULL
+    uint8_t* old_ctrl;          ///< Řídicí bajty původního indexu
+    size_t old_allocated;       ///< Velikost původního indexu
+    size_t migrated;            ///< Počet již převedených míst původního indexu
+    size_t resize_step;         ///< Počet míst převáděných za operaci, 0 vypíná postupnou realokaci
 } hash_map_t;
 
 /*******************************************************************************
@@ -154,6 +230,7 @@ void hash_map_clear(hash_map_t* self);
  * @brief Realokace rezervovaného místa pro index. 
  * 
  * Funkce je implicitně volána ve funci @c hash_map_put, když je potřeba.
+ * Velikost indexu se zaokrouhlí nahoru na mocninu dvou.
  * 
  * Příklad užití:
  * @code{.c}
@@ -176,6 +253,128 @@ void hash_map_clear(hash_map_t* self);
  */
 hash_map_state_code_t hash_map_reserve(hash_map_t* self, size_t size);
 
+/**
+ * @brief Nastaví hašovací funkci a semínko tabulky.
+ *
+ * Již vložené záznamy jsou znovu zahašovány a index je přestavěn. Náhodné
+ * semínko znemožní útočníkovi připravit klíče, které v tabulce kolidují.
+ *
+ * Příklad užití:
+ * @code{.c}
+ * hash_map_t* map = hash_map_ctor();
+ * hash_map_set_hash_function(map, hash_map_wyhash, 0x9e3779b97f4a7c15);
+ * @endcode
+ *
+ * @param[in] self          Ukazatel na strukturu hašovací tabulky.
+ * @param[in] hash_function Hašovací funkce, @c NULL nastaví výchozí
+ *                          @c hash_map_wyhash .
+ * @param[in] seed          Semínko hašovací funkce.
+ *
+ * @return @c MEMORY_ERROR pokud se nepodaří alokovat nový index, tabulka pak
+ *         zůstane beze změny s původní funkcí a semínkem, jinak @c OK.
+ */
+hash_map_state_code_t hash_map_set_hash_function(
+    hash_map_t* self, hash_map_hash_function_t hash_function, size_t seed);
+
+/**
+ * @brief Zapne pro tabulku slab alokátor položek.
+ * 
+ * Položky s krátkým klíčem se pak přidělují z bloků po @p items_per_chunk
+ * položkách a uvolněné položky se recyklují. Funkce @c hash_map_clear a
+ * @c hash_map_dtor uvolňují paměť po celých blocích. Opakované volání
+ * změní velikost dalších bloků.
+ * 
+ * Příklad užití:
+ * @code{.c}
+ * hash_map_t* map = hash_map_ctor();
+ * hash_map_enable_slab(map, 4096);
+ * @endcode
+ * 
+ * @param[in] self            Ukazatel na strukturu hašovací tabulky.
+ * @param[in] items_per_chunk Počet položek v jednom bloku.
+ * 
+ * @return @c VALUE_ERROR pokud tabulka není prázdná nebo je počet položek
+ *         nulový či tak velký, že by velikost bloku přetekla,
+ *         @c MEMORY_ERROR v případě chyby alokace, jinak @c OK.
+ */
+hash_map_state_code_t hash_map_enable_slab(hash_map_t* self, 
+                                           size_t items_per_chunk);
+
+/**
+ * @brief Zapne nebo vypne postupnou realokaci indexu.
+ * 
+ * Při zapnuté postupné realokaci funkce @c hash_map_put po překročení meze
+ * zaplnění jen alokuje nový index a položky do něj převádí postupně. Každé
+ * volání @c hash_map_put , @c hash_map_get , @c hash_map_contains ,
+ * @c hash_map_pop a @c hash_map_remove převede nejvýše @p step míst
+ * původního indexu, takže žádná operace nečeká na přehašování celé
+ * tabulky. Explicitní @c hash_map_reserve , @c hash_map_shrink_to_fit a
+ * @c hash_map_set_hash_function přestavují index vždy najednou.
+ * 
+ * Příklad užití:
+ * @code{.c}
+ * hash_map_t* map = hash_map_ctor();
+ * hash_map_set_incremental_resize(map, 64);
+ * @endcode
+ * 
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ * @param[in] step Počet míst původního indexu převáděných za operaci,
+ *                 @c 0 postupnou realokaci vypne a dokončí rozpracovanou.
+ * 
+ * @see hash_map_put
+ */
+void hash_map_set_incremental_resize(hash_map_t* self, size_t step);
+
+/**
+ * @brief Výchozí hašovací funkce ve stylu wyhash.
+ *
+ * Zpracovává klíč po 64bitových slovech, dlouhé klíče ve třech nezávislých
+ * proudech po 48 bajtech. Výsledek závisí na pořadí znaků.
+ *
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * @param[in] seed   Semínko.
+ *
+ * @return Haš klíče.
+ */
+size_t hash_map_wyhash(const char* key, size_t length, size_t seed);
+
+/**
+ * @brief Původní aditivní hašovací funkce.
+ *
+ * Sčítá @c HASH_FUNCTION_PARAM_A*c+HASH_FUNCTION_PARAM_B přes znaky klíče,
+ * takže nezávisí na pořadí znaků. Semínko ignoruje.
+ *
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * @param[in] seed   Semínko.
+ *
+ * @return Haš klíče.
+ */
+size_t hash_map_additive_hash(const char* key, size_t length, size_t seed);
+
+/**
+ * @brief Zmenší index na nejmenší velikost vhodnou pro vložené záznamy.
+ * 
+ * Index se zmenší na nejmenší mocninu dvou (alespoň @c HASH_MAP_INIT_SIZE ),
+ * při které zaplnění nedosahuje meze pro realokaci, a odstraní se z něj
+ * všechna místa s @c dummy objektem. Pokud se velikost nemění, reindexace
+ * proběhne v místě bez alokace.
+ * 
+ * Příklad užití:
+ * @code{.c}
+ * // po odstranění většiny záznamů
+ * hash_map_shrink_to_fit(map);
+ * @endcode
+ * 
+ * @param[in] self Ukazatel na strukturu hašovací tabulky.
+ * 
+ * @return @c MEMORY_ERROR v případě chyby alokace, jinak @c OK.
+ * 
+ * @see hash_map_reserve
+ */
+hash_map_state_code_t hash_map_shrink_to_fit(hash_map_t* self);
+
 /*******************************************************************************
  * Metody pro přístup k hašovací tabulce
  ******************************************************************************/
@@ -223,10 +422,14 @@ bool hash_map_contains(hash_map_t* self, const char* key);
 /**
  * @brief Vloží klíč a hodnotu do tabulky.
  * 
- * Pokud je již index tabulky zaplněn ze 2/3, realokuje pro index 2x větší místo
- * v paměti a provede reindexaci. Pokud tabulka již obsahuje k danému klíči 
- * záznam, hodnota záznamu se přepíše a funkce vrací hodnotu 
- * @c KEY_ALREADY_EXISTS .
+ * Pokud je již index tabulky zaplněn ze 3/5 (včetně míst s @c dummy objektem),
+ * realokuje pro index 2x větší místo v paměti a provede reindexaci. Pokud
+ * tvoří většinu zaplnění místa s @c dummy objektem, odstraní je reindexací
+ * v místě bez alokace nového indexu. Při zapnuté postupné realokaci se
+ * alokuje nový index (i při stejné velikosti) a položky se do něj převádí
+ * postupně v dalších operacích. Pokud tabulka již
+ * obsahuje k danému klíči záznam, hodnota záznamu se přepíše a funkce vrací
+ * hodnotu @c KEY_ALREADY_EXISTS .
  * 
  * Příklad užití:
  * @code{.c}
@@ -245,6 +448,43 @@ bool hash_map_contains(hash_map_t* self, const char* key);
 hash_map_state_code_t hash_map_put(hash_map_t* self, const char* key, 
                                    int value);
 
+/**
+ * @brief Vloží více klíčů a hodnot do tabulky najednou.
+ * 
+ * Index se předem jednou zvětší tak, aby se do něj vešly všechny vkládané
+ * klíče, takže při vkládání už nedochází k postupným realokacím. Haše se
+ * počítají po dávkách @c HASH_MAP_BATCH_SIZE klíčů. Má-li tabulka zapnutý
+ * slab alokátor, položky s krátkým klíčem leží v paměti za sebou. Klíče se
+ * vkládají v zadaném pořadí, opakovaný klíč přepíše hodnotu stejně jako
+ * u @c hash_map_put .
+ * 
+ * Příklad užití:
+ * @code{.c}
+ * const char* keys[] = {"aloha", "hello"};
+ * int values[] = {1, 2};
+ * hash_map_state_code_t error = hash_map_put_many(map, keys, values, 2, NULL);
+ * @endcode
+ * 
+ * @warning Velikost indexu se odhaduje podle počtu klíčů, opakované klíče
+ *          v dávce proto mohou vést k většímu indexu než u @c hash_map_put .
+ * 
+ * @param[in]  self     Ukazatel na strukturu hašovací tabulky.
+ * @param[in]  keys     Pole klíčů.
+ * @param[in]  values   Pole @p n hodnot k uložení.
+ * @param[in]  n        Počet klíčů.
+ * @param[out] statuses Pole pro @p n výsledků, @c OK nebo 
+ *                      @c KEY_ALREADY_EXISTS stejně jako u @c hash_map_put .
+ *                      Může být @c NULL .
+ * 
+ * @return @c MEMORY_ERROR v případě chyby alokace, klíče před chybou
+ *         zůstanou vloženy, jinak @c OK.
+ * 
+ * @see hash_map_put
+ */
+hash_map_state_code_t hash_map_put_many(hash_map_t* self, const char* const* keys,
+                                        const int* values, size_t n,
+                                        hash_map_state_code_t* statuses);
+
 /**
  * @brief Uloží hodnotu asociovanou se zadaným klíčem na určené místo v paměti.
  * 
@@ -268,6 +508,37 @@ hash_map_state_code_t hash_map_put(hash_map_t* self, const char* key,
 hash_map_state_code_t hash_map_get(hash_map_t* self, const char* key, 
                                    int* value);
 
+/**
+ * @brief Vyhledá hodnoty pro více klíčů najednou.
+ * 
+ * Klíče se zpracovávají po dávkách @c HASH_MAP_BATCH_SIZE . Nejprve se
+ * spočítají haše celé dávky a přednačtou se řídicí bajty jejich skupin,
+ * poté se přednačtou kandidátní položky a teprve nakonec se klíče
+ * porovnají. Čekání na paměť se tak u klíčů dávky překrývá.
+ * 
+ * Příklad užití:
+ * @code{.c}
+ * const char* keys[] = {"aloha", "hello"};
+ * int values[2];
+ * hash_map_state_code_t statuses[2];
+ * size_t found = hash_map_get_many(map, keys, 2, values, statuses);
+ * @endcode
+ * 
+ * @param[in]  self     Ukazatel na strukturu hašovací tabulky.
+ * @param[in]  keys     Pole klíčů.
+ * @param[in]  n        Počet klíčů.
+ * @param[out] values   Pole pro @p n hodnot, u nenalezených klíčů se 
+ *                      hodnota nemění.
+ * @param[out] statuses Pole pro @p n výsledků, @c OK nebo @c KEY_ERROR 
+ *                      stejně jako u @c hash_map_get .
+ * 
+ * @return Počet nalezených klíčů.
+ * 
+ * @see hash_map_get
+ */
+size_t hash_map_get_many(hash_map_t* self, const char* const* keys, size_t n,
+                         int* values, hash_map_state_code_t* statuses);
+
 /**
  * @brief Uloží hodnotu z hašovací tabulky a odstraní záznam.
  * 
@@ -322,6 +593,335 @@ hash_map_state_code_t hash_map_pop(hash_map_t* self, const char* key,
  */
 hash_map_state_code_t hash_map_remove(hash_map_t* self, const char* key);
 
+/*******************************************************************************
+ * Varianty s délkou klíče a předpočítaným hašem
+ ******************************************************************************/
+/**
+ * @brief Spočítá haš klíče hašovací funkcí tabulky.
+ * 
+ * Haš lze předat funkcím s příponou @c _hashed této tabulky i jiných 
+ * tabulek se stejnou hašovací funkcí a semínkem. Po změně funkce nebo 
+ * semínka pomocí @c hash_map_set_hash_function je potřeba haš spočítat znovu.
+ * 
+ * Příklad užití:
+ * @code{.c}
+ * size_t hash = hash_map_key_hash(map, "aloha", 5);
+ * hash_map_get_hashed(map, "aloha", 5, hash, &value);
+ * hash_map_get_hashed(other_map, "aloha", 5, hash, &other_value);
+ * @endcode
+ * 
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč, nemusí být ukončený nulou.
+ * @param[in] length Délka klíče v bajtech.
+ * 
+ * @return Haš klíče.
+ */
+size_t hash_map_key_hash(hash_map_t* self, const char* key, size_t length);
+
+/**
+ * @brief Varianta @c hash_map_contains pro klíč zadaný délkou.
+ * 
+ * Klíč nemusí být ukončený nulou a může obsahovat nulové bajty, klíče se
+ * porovnávají podle délky a obsahu.
+ * 
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * 
+ * @return Nenulová hodnota pokud se záznam asociovaný se zadaným klíčem
+ *         nachází v tabulce.
+ * 
+ * @see hash_map_contains
+ */
+bool hash_map_contains_n(hash_map_t* self, const char* key, size_t length);
+
+/**
+ * @brief Varianta @c hash_map_contains_n s předpočítaným hašem.
+ * 
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * @param[in] hash   Haš klíče z @c hash_map_key_hash .
+ * 
+ * @return Nenulová hodnota pokud se záznam asociovaný se zadaným klíčem
+ *         nachází v tabulce.
+ * 
+ * @see hash_map_contains
+ */
+bool hash_map_contains_hashed(hash_map_t* self, const char* key, size_t length,
+                              size_t hash);
+
+/**
+ * @brief Varianta @c hash_map_put pro klíč zadaný délkou.
+ * 
+ * Do položky se uloží @p length bajtů klíče doplněných o ukončovací nulu.
+ * 
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * @param[in] value  Hodnota k uložení.
+ * 
+ * @return Vrací @c KEY_ALREADY_EXISTS pokud se klíč nachází v tabulce,
+ *         @c MEMORY_ERROR v případě chyby alokace, jinak @c OK.
+ * 
+ * @see hash_map_put
+ */
+hash_map_state_code_t hash_map_put_n(hash_map_t* self, const char* key, 
+                                     size_t length, int value);
+
+/**
+ * @brief Varianta @c hash_map_put_n s předpočítaným hašem.
+ * 
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * @param[in] hash   Haš klíče z @c hash_map_key_hash .
+ * @param[in] value  Hodnota k uložení.
+ * 
+ * @return Vrací @c KEY_ALREADY_EXISTS pokud se klíč nachází v tabulce,
+ *         @c MEMORY_ERROR v případě chyby alokace, jinak @c OK.
+ * 
+ * @see hash_map_put
+ */
+hash_map_state_code_t hash_map_put_hashed(hash_map_t* self, const char* key, 
+                                          size_t length, size_t hash, int value);
+
+/**
+ * @brief Varianta @c hash_map_get pro klíč zadaný délkou.
+ * 
+ * @param[in]  self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in]  key    Klíč.
+ * @param[in]  length Délka klíče v bajtech.
+ * @param[out] value  Ukazatel na místo, kde se uloží hodnota.
+ * 
+ * @return Vrací @c KEY_ERROR pokud se klíč nenachází v tabulce,
+ *         jinak @c OK.
+ * 
+ * @see hash_map_get
+ */
+hash_map_state_code_t hash_map_get_n(hash_map_t* self, const char* key, 
+                                     size_t length, int* value);
+
+/**
+ * @brief Varianta @c hash_map_get_n s předpočítaným hašem.
+ * 
+ * @param[in]  self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in]  key    Klíč.
+ * @param[in]  length Délka klíče v bajtech.
+ * @param[in]  hash   Haš klíče z @c hash_map_key_hash .
+ * @param[out] value  Ukazatel na místo, kde se uloží hodnota.
+ * 
+ * @return Vrací @c KEY_ERROR pokud se klíč nenachází v tabulce,
+ *         jinak @c OK.
+ * 
+ * @see hash_map_get
+ */
+hash_map_state_code_t hash_map_get_hashed(hash_map_t* self, const char* key, 
+                                          size_t length, size_t hash, int* value);
+
+/**
+ * @brief Vrátí kopii klíče uloženou v tabulce.
+ * 
+ * Položky se při realokaci indexu nepřesouvají, vrácený ukazatel proto
+ * zůstává platný, dokud se záznam z tabulky neodstraní. Volající tak může
+ * na klíč odkazovat bez vlastní kopie.
+ * 
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * @param[in] hash   Haš klíče z @c hash_map_key_hash .
+ * 
+ * @return Uložený klíč ukončený nulou, @c NULL pokud se klíč nenachází
+ *         v tabulce.
+ */
+const char* hash_map_stored_key_hashed(hash_map_t* self, const char* key, 
+                                       size_t length, size_t hash);
+
+/**
+ * @brief Varianta @c hash_map_pop pro klíč zadaný délkou.
+ * 
+ * @param[in]  self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in]  key    Klíč.
+ * @param[in]  length Délka klíče v bajtech.
+ * @param[out] value  Ukazatel na místo, kde se uloží hodnota.
+ * 
+ * @return Vrací @c KEY_ERROR pokud se klíč nenachází v tabulce,
+ *         jinak @c OK.
+ * 
+ * @see hash_map_pop
+ */
+hash_map_state_code_t hash_map_pop_n(hash_map_t* self, const char* key, 
+                                     size_t length, int* value);
+
+/**
+ * @brief Varianta @c hash_map_pop_n s předpočítaným hašem.
+ * 
+ * @param[in]  self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in]  key    Klíč.
+ * @param[in]  length Délka klíče v bajtech.
+ * @param[in]  hash   Haš klíče z @c hash_map_key_hash .
+ * @param[out] value  Ukazatel na místo, kde se uloží hodnota.
+ * 
+ * @return Vrací @c KEY_ERROR pokud se klíč nenachází v tabulce,
+ *         jinak @c OK.
+ * 
+ * @see hash_map_pop
+ */
+hash_map_state_code_t hash_map_pop_hashed(hash_map_t* self, const char* key, 
+                                          size_t length, size_t hash, int* value);
+
+/**
+ * @brief Varianta @c hash_map_remove pro klíč zadaný délkou.
+ * 
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * 
+ * @return Vrací @c KEY_ERROR pokud se klíč nenachází v tabulce,
+ *         jinak @c OK.
+ * 
+ * @see hash_map_remove
+ */
+hash_map_state_code_t hash_map_remove_n(hash_map_t* self, const char* key, 
+                                        size_t length);
+
+/**
+ * @brief Varianta @c hash_map_remove_n s předpočítaným hašem.
+ * 
+ * @param[in] self   Ukazatel na strukturu hašovací tabulky.
+ * @param[in] key    Klíč.
+ * @param[in] length Délka klíče v bajtech.
+ * @param[in] hash   Haš klíče z @c hash_map_key_hash .
+ * 
+ * @return Vrací @c KEY_ERROR pokud se klíč nenachází v tabulce,
+ *         jinak @c OK.
+ * 
+ * @see hash_map_remove
+ */
+hash_map_state_code_t hash_map_remove_hashed(hash_map_t* self, const char* key, 
+                                             size_t length, size_t hash);
+
+/*******************************************************************************
+ * Souběžná hašovací tabulka
+ ******************************************************************************/
+/**
+ * @brief Hašovací tabulka bezpečná pro souběžný přístup z více vláken.
+ * 
+ * Struktura je skrytá, pracuje se s ní jen pomocí funkcí níže. Položky jsou
+ * v řetězcích pro jednotlivé koše indexu. Zapisovatelé zamykají jeden z
+ * @c CONCURRENT_HASH_MAP_STRIPES zámků podle haše klíče, realokace indexu
+ * zamyká všechny. Čtenáři žádný zámek nedrží, index procházejí přes
+ * atomické ukazatele a jen se přihlásí do aktuální epochy. Odstraněné
+ * položky a původní indexy se uvolní až po skončení všech čtenářů, kteří
+ * je mohli vidět.
+ */
+typedef struct concurrent_hash_map concurrent_hash_map_t;
+
+/**
+ * @brief Konstruktor souběžné hašovací tabulky.
+ * 
+ * Příklad užití:
+ * @code{.c}
+ * concurrent_hash_map_t* map = concurrent_hash_map_ctor();
+ * // do something
+ * concurrent_hash_map_dtor(map);
+ * @endcode
+ * 
+ * @return Ukazatel na inicializovanou tabulku. V případě chyby alokace
+ *         vrací hodnotu @c NULL.
+ */
+concurrent_hash_map_t* concurrent_hash_map_ctor();
+
+/**
+ * @brief Destruktor souběžné hašovací tabulky.
+ * 
+ * Uvolní všechny položky a tabulku. Žádné jiné vlákno s tabulkou v tu
+ * chvíli nesmí pracovat.
+ * 
+ * @param[in] self Ukazatel na tabulku.
+ */
+void concurrent_hash_map_dtor(concurrent_hash_map_t* self);
+
+/**
+ * @brief Vrací počet vložených záznamů do tabulky.
+ * 
+ * @param[in] self Ukazatel na tabulku.
+ * 
+ * @return Počet vložených záznamů, při souběžných zápisech jen přibližně.
+ */
+size_t concurrent_hash_map_size(concurrent_hash_map_t* self);
+
+/**
+ * @brief Vloží klíč a hodnotu do tabulky.
+ * 
+ * Stejně jako @c hash_map_put přepíše hodnotu již vloženého klíče. Po 
+ * překročení zaplnění indexu jeho velikost zdvojnásobí.
+ * 
+ * @param[in] self  Ukazatel na tabulku.
+ * @param[in] key   Klíč do tabulky.
+ * @param[in] value Hodnota k uložení.
+ * 
+ * @return @c KEY_ALREADY_EXISTS pokud se klíč nachází v tabulce,
+ *         @c MEMORY_ERROR v případě chyby alokace, jinak @c OK.
+ * 
+ * @see hash_map_put
+ */
+hash_map_state_code_t concurrent_hash_map_put(concurrent_hash_map_t* self, 
+                                              const char* key, int value);
+
+/**
+ * @brief Uloží hodnotu asociovanou se zadaným klíčem bez zamykání.
+ * 
+ * @param[in]  self  Ukazatel na tabulku.
+ * @param[in]  key   Klíč do tabulky.
+ * @param[out] value Ukazatel na místo, kde se uloží hodnota.
+ * 
+ * @return @c KEY_ERROR pokud se klíč nenachází v tabulce, jinak @c OK.
+ * 
+ * @see hash_map_get
+ */
+hash_map_state_code_t concurrent_hash_map_get(concurrent_hash_map_t* self, 
+                                              const char* key, int* value);
+
+/**
+ * @brief Obsahuje tabulka záznam s daným klíčem? Nezamyká.
+ * 
+ * @param[in] self Ukazatel na tabulku.
+ * @param[in] key  Klíč do tabulky.
+ * 
+ * @return Nenulová hodnota pokud se záznam nachází v tabulce.
+ * 
+ * @see hash_map_contains
+ */
+bool concurrent_hash_map_contains(concurrent_hash_map_t* self, const char* key);
+
+/**
+ * @brief Uloží hodnotu z tabulky a odstraní záznam.
+ * 
+ * @param[in]  self  Ukazatel na tabulku.
+ * @param[in]  key   Klíč do tabulky.
+ * @param[out] value Ukazatel na místo, kde se uloží hodnota.
+ * 
+ * @return @c KEY_ERROR pokud se klíč nenachází v tabulce, jinak @c OK.
+ * 
+ * @see hash_map_pop
+ */
+hash_map_state_code_t concurrent_hash_map_pop(concurrent_hash_map_t* self, 
+                                              const char* key, int* value);
+
+/**
+ * @brief Odstranění položky z tabulky.
+ * 
+ * @param[in] self Ukazatel na tabulku.
+ * @param[in] key  Klíč do tabulky.
+ * 
+ * @return @c KEY_ERROR pokud se klíč nenachází v tabulce, jinak @c OK.
+ * 
+ * @see hash_map_remove
+ */
+hash_map_state_code_t concurrent_hash_map_remove(concurrent_hash_map_t* self, 
+                                                 const char* key);
+
 }       // extern "C" ending
 
 #endif  // HASH_MAP_H_
@@ -14,6 +14,9 @@
  */
 
 #include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
 #include <gmock/gmock-matchers.h>
 
 #include "gtest/gtest.h"
@@ -194,6 +197,21 @@ TEST_F(NonEmptyMapTest, reserve_Bigger) {
     EXPECT_EQ(hash_map_reserve(map, map->allocated * 2), OK);
 }
 
+TEST_F(NonEmptyMapTest, reserve_KeepsKeys) {
+    // Rehash must place items by the new index size
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(hash_map_put(map, ("key" + std::to_string(i)).c_str(), i), OK);
+    }
+
+    int value;
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(hash_map_get(map, ("key" + std::to_string(i)).c_str(), &value), OK);
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_EQ(hash_map_get(map, "20", &value), OK);
+    EXPECT_EQ(value, 20);
+}
+
 //============================================================================//
 // NonEmptyMapTest - hash_map_contains
 //============================================================================//
@@ -337,4 +355,478 @@ TEST_F(NonEmptyMapTest, HashCollisions) {
     EXPECT_EQ(hash_map_contains(map, "ba"), true);
 }
 
+//============================================================================//
+// Hash functions
+//============================================================================//
+
+TEST_F(EmptyMapTest, hash_OrderSensitive) {
+    EXPECT_NE(hash_map_wyhash("ab", 2, 0), hash_map_wyhash("ba", 2, 0));
+    EXPECT_NE(hash_map_wyhash("listen", 6, 0), hash_map_wyhash("silent", 6, 0));
+    EXPECT_EQ(hash_map_additive_hash("ab", 2, 0), hash_map_additive_hash("ba", 2, 0));
+
+    // Seed changes the hash, long keys go through all loops
+    std::string long_key(200, 'x');
+    EXPECT_NE(hash_map_wyhash("ab", 2, 0), hash_map_wyhash("ab", 2, 1));
+    EXPECT_EQ(hash_map_wyhash(long_key.c_str(), long_key.size(), 7),
+              hash_map_wyhash(long_key.c_str(), long_key.size(), 7));
+    long_key[150] = 'y';
+    EXPECT_NE(hash_map_wyhash(long_key.c_str(), long_key.size(), 7),
+              hash_map_wyhash(std::string(200, 'x').c_str(), 200, 7));
+}
+
+TEST_F(NonEmptyMapTest, setHashFunction_KeepsKeys) {
+    EXPECT_EQ(hash_map_put(map, "ab", 100), OK);
+    EXPECT_EQ(hash_map_set_hash_function(map, hash_map_additive_hash, 0), OK);
+    EXPECT_EQ(map->hash_function, hash_map_additive_hash);
+
+    int value;
+    EXPECT_EQ(hash_map_get(map, "ab", &value), OK);
+    EXPECT_EQ(value, 100);
+    EXPECT_EQ(hash_map_put(map, "ba", 200), OK);
+    EXPECT_EQ(map->last->hash, hash_map_additive_hash("ab", 2, 0));
+
+    EXPECT_EQ(hash_map_set_hash_function(map, NULL, 42), OK);
+    EXPECT_EQ(map->hash_function, hash_map_wyhash);
+    EXPECT_EQ(map->seed, 42);
+    EXPECT_EQ(hash_map_get(map, "ba", &value), OK);
+    EXPECT_EQ(value, 200);
+    EXPECT_EQ(hash_map_get(map, "10", &value), OK);
+    EXPECT_EQ(value, 10);
+    EXPECT_EQ(hash_map_size(map), 5);
+}
+
+//============================================================================//
+// Control bytes
+//============================================================================//
+
+TEST_F(NonEmptyMapTest, ctrl_TracksIndex) {
+    size_t occupied = 0;
+    for (size_t i = 0; i < map->allocated; ++i) {
+        if (map->index[i] == NULL) {
+            EXPECT_EQ(map->ctrl[i], HASH_MAP_CTRL_EMPTY);
+        } else {
+            EXPECT_EQ(map->ctrl[i], map->index[i]->hash & 0x7f);
+            ++occupied;
+        }
+        // Control bytes of the first group are cloned behind the array
+        if (i < HASH_MAP_GROUP_WIDTH) {
+            EXPECT_EQ(map->ctrl[map->allocated + i], map->ctrl[i]);
+        }
+    }
+    EXPECT_EQ(occupied, 3);
+
+    EXPECT_EQ(hash_map_remove(map, "20"), OK);
+    for (size_t i = 0; i < map->allocated; ++i) {
+        if (map->index[i] == map->dummy) {
+            EXPECT_EQ(map->ctrl[i], HASH_MAP_CTRL_DELETED);
+        }
+    }
+    EXPECT_EQ(hash_map_contains(map, "30"), true);
+}
+
+TEST_F(EmptyMapTest, reserve_RoundsToPowerOfTwo) {
+    EXPECT_EQ(hash_map_reserve(map, 20), OK);
+    EXPECT_EQ(hash_map_capacity(map), 32);
+    EXPECT_EQ(hash_map_reserve(map, 1), OK);
+    EXPECT_EQ(hash_map_capacity(map), 1);
+    EXPECT_EQ(hash_map_put(map, "10", 10), OK);
+    EXPECT_EQ(hash_map_put(map, "20", 20), OK);
+    EXPECT_EQ(hash_map_contains(map, "10"), true);
+}
+
+//============================================================================//
+// Inline keys
+//============================================================================//
+
+TEST_F(EmptyMapTest, put_InlineKeys) {
+    std::string long_key(100, 'k');
+    EXPECT_EQ(hash_map_put(map, "short", 1), OK);
+    EXPECT_EQ(map->last->key, map->last->inline_key);
+    EXPECT_EQ(map->last->key_len, 5);
+    EXPECT_EQ(hash_map_put(map, long_key.c_str(), 2), OK);
+    EXPECT_EQ(map->last->key, map->last->inline_key);
+    EXPECT_EQ(map->last->key_len, 100);
+    EXPECT_STREQ(map->last->key, long_key.c_str());
+
+    int value;
+    EXPECT_EQ(hash_map_get(map, long_key.c_str(), &value), OK);
+    EXPECT_EQ(value, 2);
+    // Prefix of a stored key is a different key
+    EXPECT_EQ(hash_map_get(map, long_key.substr(0, 99).c_str(), &value), KEY_ERROR);
+    EXPECT_EQ(hash_map_pop(map, "short", &value), OK);
+    EXPECT_EQ(value, 1);
+}
+
+//============================================================================//
+// Slab allocator
+//============================================================================//
+
+TEST_F(EmptyMapTest, slab_RecyclesItems) {
+    EXPECT_EQ(hash_map_enable_slab(map, 0), VALUE_ERROR);
+    EXPECT_EQ(hash_map_enable_slab(map, SIZE_MAX / sizeof(hash_map_item_t)), VALUE_ERROR);
+    EXPECT_EQ(hash_map_enable_slab(map, 4), OK);
+
+    std::string long_key(40, 'k');
+    EXPECT_EQ(hash_map_put(map, "10", 10), OK);
+    EXPECT_EQ(hash_map_put(map, "20", 20), OK);
+    EXPECT_EQ(hash_map_put(map, long_key.c_str(), 30), OK);
+    EXPECT_EQ(map->slab->large_items, 1);
+    EXPECT_EQ(map->slab->remaining, 2);
+
+    // Freed item is reused by the next short key
+    hash_map_item_t* freed = map->first;
+    EXPECT_EQ(hash_map_remove(map, "10"), OK);
+    EXPECT_EQ(map->slab->free_list, freed);
+    EXPECT_EQ(hash_map_put(map, "40", 40), OK);
+    EXPECT_EQ(map->last, freed);
+    EXPECT_EQ(map->slab->free_list, nullptr);
+
+    int value;
+    EXPECT_EQ(hash_map_get(map, long_key.c_str(), &value), OK);
+    EXPECT_EQ(value, 30);
+
+    hash_map_clear(map);
+    EXPECT_EQ(map->slab->chunks, nullptr);
+    EXPECT_EQ(map->slab->large_items, 0);
+    EXPECT_EQ(hash_map_put(map, "50", 50), OK);
+    EXPECT_EQ(hash_map_enable_slab(map, 8), VALUE_ERROR);
+}
+
+//============================================================================//
+// Tombstones
+//============================================================================//
+
+TEST_F(NonEmptyMapTest, remove_Churn) {
+    // Constant live size must not keep doubling the index
+    for (int i = 0; i < 1000; ++i) {
+        std::string key = "churn" + std::to_string(i);
+        EXPECT_EQ(hash_map_put(map, key.c_str(), i), OK);
+        EXPECT_EQ(hash_map_remove(map, key.c_str()), OK);
+    }
+    EXPECT_EQ(hash_map_size(map), 3);
+    EXPECT_LE(hash_map_capacity(map), 16);
+    EXPECT_LE(map->used + map->deleted, map->allocated);
+    EXPECT_EQ(hash_map_contains(map, "20"), true);
+}
+
+TEST_F(NonEmptyMapTest, remove_ChurnSweepsInPlace) {
+    // Sweeping tombstones at the same size reuses the index buffers
+    for (int i = 0; i < 100; ++i) {
+        std::string key = "warmup" + std::to_string(i);
+        EXPECT_EQ(hash_map_put(map, key.c_str(), i), OK);
+        EXPECT_EQ(hash_map_remove(map, key.c_str()), OK);
+    }
+    size_t capacity = hash_map_capacity(map);
+    hash_map_item_t** index = map->index;
+    uint8_t* ctrl = map->ctrl;
+    for (int i = 0; i < 1000; ++i) {
+        std::string key = "churn" + std::to_string(i);
+        EXPECT_EQ(hash_map_put(map, key.c_str(), i), OK);
+        EXPECT_EQ(hash_map_remove(map, key.c_str()), OK);
+    }
+    EXPECT_EQ(hash_map_capacity(map), capacity);
+    EXPECT_EQ(map->index, index);
+    EXPECT_EQ(map->ctrl, ctrl);
+    int value;
+    EXPECT_EQ(hash_map_get(map, "30", &value), OK);
+    EXPECT_EQ(value, 30);
+}
+
+TEST_F(NonEmptyMapTest, shrinkToFit) {
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(hash_map_put(map, ("key" + std::to_string(i)).c_str(), i), OK);
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(hash_map_remove(map, ("key" + std::to_string(i)).c_str()), OK);
+    }
+    EXPECT_EQ(map->deleted, 100);
+    EXPECT_EQ(hash_map_capacity(map), 256);
+
+    EXPECT_EQ(hash_map_shrink_to_fit(map), OK);
+    EXPECT_EQ(hash_map_capacity(map), 8);
+    EXPECT_EQ(map->deleted, 0);
+    int value;
+    EXPECT_EQ(hash_map_get(map, "30", &value), OK);
+    EXPECT_EQ(value, 30);
+}
+
+//============================================================================//
+// Batched lookup
+//============================================================================//
+
+TEST_F(NonEmptyMapTest, getMany) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 40; ++i) {
+        names.push_back("key" + std::to_string(i));
+        if (i % 2 == 0) {
+            EXPECT_EQ(hash_map_put(map, names.back().c_str(), i), OK);
+        }
+    }
+    names.push_back("20");
+
+    std::vector<const char*> keys;
+    for (const std::string& name : names) {
+        keys.push_back(name.c_str());
+    }
+    std::vector<int> values(keys.size(), -1);
+    std::vector<hash_map_state_code_t> statuses(keys.size());
+
+    EXPECT_EQ(hash_map_get_many(map, keys.data(), keys.size(), values.data(), statuses.data()), 21);
+    for (int i = 0; i < 40; ++i) {
+        EXPECT_EQ(statuses[i], i % 2 == 0 ? OK : KEY_ERROR);
+        EXPECT_EQ(values[i], i % 2 == 0 ? i : -1);
+    }
+    EXPECT_EQ(statuses[40], OK);
+    EXPECT_EQ(values[40], 20);
+    EXPECT_EQ(hash_map_get_many(map, keys.data(), 0, values.data(), statuses.data()), 0);
+}
+
+TEST_F(EmptyMapTest, putMany) {
+    std::vector<std::string> names;
+    std::vector<int> values;
+    for (int i = 0; i < 100; ++i) {
+        names.push_back("key" + std::to_string(i));
+        values.push_back(i);
+    }
+    names.push_back("key7");
+    values.push_back(-7);
+
+    std::vector<const char*> keys;
+    for (const std::string& name : names) {
+        keys.push_back(name.c_str());
+    }
+    std::vector<hash_map_state_code_t> statuses(keys.size());
+
+    // index is sized once for the whole load
+    EXPECT_EQ(hash_map_put_many(map, keys.data(), values.data(), keys.size(), statuses.data()), OK);
+    EXPECT_EQ(hash_map_size(map), 100);
+    EXPECT_EQ(hash_map_capacity(map), 256);
+    EXPECT_EQ(statuses[0], OK);
+    EXPECT_EQ(statuses[100], KEY_ALREADY_EXISTS);
+
+    int value;
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(hash_map_get(map, keys[i], &value), OK);
+        EXPECT_EQ(value, i == 7 ? -7 : i);
+    }
+    // insertion order is kept
+    EXPECT_STREQ(map->first->key, "key0");
+    EXPECT_STREQ(map->last->key, "key99");
+
+    EXPECT_EQ(hash_map_put_many(map, keys.data(), values.data(), 0, NULL), OK);
+    EXPECT_EQ(hash_map_size(map), 100);
+}
+
+TEST_F(EmptyMapTest, incrementalResize) {
+    hash_map_set_incremental_resize(map, 2);
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; ++i) {
+        names.push_back("key" + std::to_string(i));
+    }
+
+    int value;
+    bool seen_old_index = false;
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(hash_map_put(map, names[i].c_str(), i), OK);
+        seen_old_index |= map->old_index != NULL;
+        // every key stays reachable while items move between the indexes
+        for (int j = 0; j <= i; j += 17) {
+            EXPECT_EQ(hash_map_get(map, names[j].c_str(), &value), OK);
+            EXPECT_EQ(value, j);
+        }
+    }
+    EXPECT_TRUE(seen_old_index);
+    EXPECT_EQ(hash_map_size(map), 200);
+    EXPECT_EQ(hash_map_capacity(map), 512);
+
+    for (int i = 0; i < 200; i += 2) {
+        EXPECT_EQ(hash_map_pop(map, names[i].c_str(), &value), OK);
+        EXPECT_EQ(value, i);
+    }
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(hash_map_contains(map, names[i].c_str()), i % 2 == 1);
+    }
+
+    // disabling finishes the pending migration
+    hash_map_set_incremental_resize(map, 0);
+    EXPECT_EQ(map->old_index, nullptr);
+    EXPECT_EQ(hash_map_size(map), 100);
+}
+
+TEST_F(EmptyMapTest, incrementalResize_Reserve) {
+    hash_map_set_incremental_resize(map, 1);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(hash_map_put(map, std::to_string(i).c_str(), i), OK);
+    }
+    EXPECT_NE(map->old_index, nullptr);
+
+    // explicit reserve rebuilds the whole index at once
+    EXPECT_EQ(hash_map_reserve(map, 64), OK);
+    EXPECT_EQ(map->old_index, nullptr);
+    int value;
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(hash_map_get(map, std::to_string(i).c_str(), &value), OK);
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST_F(NonEmptyMapTest, lengthAwareKeys) {
+    // "204" sliced to "20" matches the stored key
+    const char* slice = "204";
+    int value;
+    EXPECT_EQ(hash_map_get_n(map, slice, 2, &value), OK);
+    EXPECT_EQ(value, 20);
+    EXPECT_TRUE(hash_map_contains_n(map, slice, 2));
+    EXPECT_FALSE(hash_map_contains_n(map, slice, 3));
+
+    // stored slices are terminated, keys with embedded zero bytes are distinct
+    EXPECT_EQ(hash_map_put_n(map, "abcdef", 3, 1), OK);
+    EXPECT_EQ(hash_map_put_n(map, "ab\0c", 4, 2), OK);
+    EXPECT_EQ(hash_map_put_n(map, "ab", 2, 3), OK);
+    EXPECT_EQ(hash_map_get(map, "abc", &value), OK);
+    EXPECT_EQ(value, 1);
+    EXPECT_EQ(hash_map_get_n(map, "ab\0c", 4, &value), OK);
+    EXPECT_EQ(value, 2);
+    EXPECT_EQ(hash_map_get(map, "ab", &value), OK);
+    EXPECT_EQ(value, 3);
+
+    EXPECT_EQ(hash_map_pop_n(map, "ab\0c", 4, &value), OK);
+    EXPECT_EQ(value, 2);
+    EXPECT_EQ(hash_map_remove_n(map, "abcx", 3), OK);
+    EXPECT_EQ(hash_map_remove_n(map, "abcx", 3), KEY_ERROR);
+    EXPECT_EQ(hash_map_size(map), 4);
+}
+
+TEST_F(NonEmptyMapTest, preHashedKeys) {
+    hash_map_t* other = hash_map_ctor();
+    hash_map_put(other, "10", 100);
+
+    // one hash serves every map with the same hash function and seed
+    size_t hash = hash_map_key_hash(map, "10", 2);
+    int value;
+    EXPECT_EQ(hash_map_get_hashed(map, "10", 2, hash, &value), OK);
+    EXPECT_EQ(value, 10);
+    EXPECT_EQ(hash_map_get_hashed(other, "10", 2, hash, &value), OK);
+    EXPECT_EQ(value, 100);
+    EXPECT_TRUE(hash_map_contains_hashed(other, "10", 2, hash));
+
+    const char* stored = hash_map_stored_key_hashed(other, "10", 2, hash);
+    ASSERT_NE(stored, nullptr);
+    EXPECT_STREQ(stored, "10");
+    EXPECT_EQ(stored, other->first->key);
+    EXPECT_EQ(hash_map_stored_key_hashed(other, "11", 2, hash_map_key_hash(other, "11", 2)), nullptr);
+
+    size_t new_hash = hash_map_key_hash(map, "40", 2);
+    EXPECT_EQ(hash_map_put_hashed(map, "40", 2, new_hash, 40), OK);
+    EXPECT_EQ(hash_map_put_hashed(map, "40", 2, new_hash, 41), KEY_ALREADY_EXISTS);
+    EXPECT_EQ(hash_map_get(map, "40", &value), OK);
+    EXPECT_EQ(value, 41);
+    EXPECT_EQ(hash_map_pop_hashed(map, "40", 2, new_hash, &value), OK);
+    EXPECT_EQ(value, 41);
+    EXPECT_FALSE(hash_map_contains(map, "40"));
+
+    size_t other_hash = hash_map_key_hash(other, "10", 2);
+    EXPECT_EQ(hash_map_remove_hashed(other, "10", 2, other_hash), OK);
+    EXPECT_EQ(hash_map_remove_hashed(other, "10", 2, other_hash), KEY_ERROR);
+    EXPECT_EQ(hash_map_size(other), 0);
+
+    hash_map_dtor(other);
+}
+
+//============================================================================//
+// ConcurrentMapTest - concurrent_hash_map_t
+//============================================================================//
+
+// Test suite for testing concurrent hash map
+class ConcurrentMapTest : public ::testing::Test {
+protected:
+    concurrent_hash_map_t* map;
+
+    void SetUp() override {
+        map = concurrent_hash_map_ctor();
+    }
+
+    void TearDown() override {
+        concurrent_hash_map_dtor(map);
+    }
+};
+
+TEST_F(ConcurrentMapTest, singleThread) {
+    int value;
+    EXPECT_EQ(concurrent_hash_map_size(map), 0);
+    EXPECT_EQ(concurrent_hash_map_get(map, "missing", &value), KEY_ERROR);
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(concurrent_hash_map_put(map, std::to_string(i).c_str(), i), OK);
+    }
+    EXPECT_EQ(concurrent_hash_map_put(map, "7", -7), KEY_ALREADY_EXISTS);
+    EXPECT_EQ(concurrent_hash_map_size(map), 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(concurrent_hash_map_get(map, std::to_string(i).c_str(), &value), OK);
+        EXPECT_EQ(value, i == 7 ? -7 : i);
+    }
+
+    EXPECT_EQ(concurrent_hash_map_pop(map, "7", &value), OK);
+    EXPECT_EQ(value, -7);
+    EXPECT_EQ(concurrent_hash_map_remove(map, "8"), OK);
+    EXPECT_EQ(concurrent_hash_map_remove(map, "8"), KEY_ERROR);
+    EXPECT_FALSE(concurrent_hash_map_contains(map, "7"));
+    EXPECT_TRUE(concurrent_hash_map_contains(map, "9"));
+    EXPECT_EQ(concurrent_hash_map_size(map), 998);
+}
+
+TEST_F(ConcurrentMapTest, readersAndWriters) {
+    const int stable = 500;
+    for (int i = 0; i < stable; ++i) {
+        concurrent_hash_map_put(map, ("stable" + std::to_string(i)).c_str(), i);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            int value;
+            for (int i = t; !done.load(); i = (i + 7) % stable) {
+                // keys present from the start must stay visible while the index grows
+                std::string key = "stable" + std::to_string(i);
+                if (concurrent_hash_map_get(map, key.c_str(), &value) != OK || value != i) {
+                    errors++;
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                std::string key = "w" + std::to_string(t) + "_" + std::to_string(i);
+                concurrent_hash_map_put(map, key.c_str(), i);
+            }
+            for (int i = 0; i < 2000; i += 2) {
+                std::string key = "w" + std::to_string(t) + "_" + std::to_string(i);
+                int value;
+                if (concurrent_hash_map_pop(map, key.c_str(), &value) != OK || value != i) {
+                    errors++;
+                }
+            }
+        });
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(concurrent_hash_map_size(map), stable + 4 * 1000);
+    EXPECT_TRUE(concurrent_hash_map_contains(map, "w3_1999"));
+    EXPECT_FALSE(concurrent_hash_map_contains(map, "w3_1998"));
+}
+
 /*** Konec souboru white_box_tests.cpp ***/
\ No newline at end of file